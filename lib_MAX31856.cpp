@@ -48,143 +48,818 @@
 
 #define LOG(args...)    printf(args)
 
+#if MAX31856_INSTRUMENTATION
+#define INSTRUMENT_COUNT(counter)        instrumentation.counter++
+#define INSTRUMENT_LATENCY(histogram)    LatencyMeter latency_meter(this, instrumentation.histogram)
+#else
+#define INSTRUMENT_COUNT(counter)
+#define INSTRUMENT_LATENCY(histogram)
+#endif
+
+#if MAX31856_BUS_STATS
+#define BUS_METER(method)                BusMeter bus_meter(this, method)
+#else
+#define BUS_METER(method)
+#endif
+
+MAX31856::SpiOwner MAX31856::spi_owners[MAX31856_SPI_OBJECTS];
+
 //*****************************************************************************
 MAX31856::MAX31856(SPI& _spi, PinName _ncs, uint8_t _type, uint8_t _fltr, uint8_t _samples, uint8_t _conversion_mode) : spi(_spi), ncs(_ncs), samples(_samples)
 {
+    spi.lock();
     spi.format(8,3); //configure the correct SPI mode to beable to program the registers intially correctly
-    init_MAX31856 &= setThermocoupleType(_type);
-    init_MAX31856 &= setEmiFilterFreq(_fltr);
-    init_MAX31856 &= setNumSamplesAvg(_samples);
-    init_MAX31856 &= setConversionMode(_conversion_mode);
-    lastReadTime = time(NULL);
-    wait_us(1000000);
+    spi.frequency(spi_hz);
+    spi_owner = spiOwnerEntry(&spi);
+    if(spi_owner) core_util_atomic_store_ptr(&spi_owner->owner, this);
+    spi.unlock();
+    sync(); //cache the configuration registers so the setters below only need to write
+    beginConfig();
+    bool valid = setThermocoupleType(_type);
+    valid &= setEmiFilterFreq(_fltr);
+    valid &= setNumSamplesAvg(_samples);
+    valid &= setConversionMode(_conversion_mode);
+    begin(); //write the configuration in a single frame and read it back, the first conversion completes in the background
+    init_MAX31856 &= valid;
+}
+
+
+//*****************************************************************************
+MAX31856::MAX31856(SPI& _spi, PinName _ncs, RegisterConfig config) : spi(_spi), ncs(_ncs)
+{
+    spi.lock();
+    spi.format(8,3); //configure the correct SPI mode to beable to program the registers intially correctly
+    spi.frequency(spi_hz);
+    spi_owner = spiOwnerEntry(&spi);
+    if(spi_owner) core_util_atomic_store_ptr(&spi_owner->owner, this);
+    spi.unlock();
+    sync(); //cache the other configuration registers for verifyConfig()
+    shadow_reg[ADDRESS_CR0_READ] = config.cr0 & ~CR0_SELF_CLEARING_BITS;
+    shadow_reg[ADDRESS_CR1_READ] = config.cr1;
+    decodeConfig();
+    begin(); //write the configuration in a single frame and read it back, the first conversion completes in the background
+}
+
+
+//*****************************************************************************
+bool MAX31856::begin()
+{
+    BUS_METER(BUS_CONFIG);
+    config_staged = false;
+    staged_len = 0;
+    encodeConfig(); //never write back a floating bus read by sync()
+    registerWriteBlock(ADDRESS_CR0_WRITE, shadow_reg, CONFIG_REGISTER_COUNT); //CR0 to CJTO in a single frame
+    init_MAX31856 = verifyConfig();
+    one_shot_pending = false;
+    thermocouple_conversion_count = 0;
+    conversion_start_time = begin_time = clock_us();
+    if(init_MAX31856 && conversion_mode==0) //start the first 1-shot conversion so the first result is ready after the conversion time
+        init_MAX31856 = triggerOneShot();
+    return init_MAX31856;
+}
+
+
+//*****************************************************************************
+void MAX31856::decodeConfig()
+{
+    uint8_t cr0 = shadow_reg[ADDRESS_CR0_READ], cr1 = shadow_reg[ADDRESS_CR1_READ];
+    conversion_mode = cr0 & CR0_CONV_MODE_NORMALLY_ON;
+    filter_mode = cr0 & CR0_FILTER_OUT_50Hz;
+    cold_junction_enabled = !(cr0 & CR0_COLD_JUNC_DISABLE);
+    fault_mode = cr0 & CR0_FAULT_MODE_INTERUPT;
+    oc_detect = cr0 & ~CR0_CLEAR_BITS_5_4;
+    samples = 1 << ((cr1 >> 4) & 0x07);
+    tc_type = cr1 & ~CR1_CLEAR_BITS_3_0;
+    voltage_mode = tc_type & CR1_TC_TYPE_VOLT_MODE_GAIN_8;
+    voltage_gain = (tc_type == CR1_TC_TYPE_VOLT_MODE_GAIN_32) ? MAX31856_VOLTAGE_GAIN_32 : MAX31856_VOLTAGE_GAIN_8;
+}
+
+
+//*****************************************************************************
+void MAX31856::encodeConfig()
+{
+    uint8_t avg = 0;
+    while(avg < 4 && (1 << avg) < samples) avg++;
+    shadow_reg[ADDRESS_CR0_READ] = (conversion_mode ? CR0_CONV_MODE_NORMALLY_ON : CR0_CONV_MODE_NORMALLY_OFF) | oc_detect
+                                 | (cold_junction_enabled ? CR0_COLD_JUNC_ENABLE : CR0_COLD_JUNC_DISABLE) | fault_mode
+                                 | (filter_mode ? CR0_FILTER_OUT_50Hz : CR0_FILTER_OUT_60Hz);
+    shadow_reg[ADDRESS_CR1_READ] = (avg << 4) | tc_type;
+}
+
+
+//*****************************************************************************
+bool MAX31856::isInitialized() const
+{
+    if(!init_MAX31856) return false;
+    if(thermocouple_conversion_count) return true;
+    return clock_us() - begin_time >= delayTime();
 }
 
 
 //*****************************************************************************
 float MAX31856::readTC()
 {
+    int32_t temp = readTCRaw();
+    return rawToTC(temp, prev_CJ_raw);
+}
+
+
+//*****************************************************************************
+float MAX31856::readTCVoltage()
+{
+    if(!voltage_mode) return NAN;
+    int32_t temp = readTCRaw();
+    return (temp == TC_RAW_INVALID) ? NAN : MAX31856Linearization::codeToMillivolts(temp, voltage_gain);
+}
+
+
+//*****************************************************************************
+int32_t MAX31856::readTCRaw()
+{
+    BUS_METER(BUS_READ_TC);
+    INSTRUMENT_LATENCY(tc_latency);
+    result_reported = false;
+    if(!init_MAX31856) {
+        INSTRUMENT_COUNT(init_failures);
+        return TC_RAW_INVALID;
+    }
     //Check and see if the MAX31856 is set to conversion mode ALWAYS ON
-    if (conversion_mode==0) {   //means that the conversion mode is normally off
-        init_MAX31856 &= setOneShotMode(CR0_1_SHOT_MODE_ONE_CONVERSION); // turn on the one shot mode for singular conversion
-        thermocouple_conversion_count=0; //reset the conversion count back to zero to make sure minimum conversion time reflects one shot mode requirements
+    if (conversion_mode==0 && !one_shot_pending) {   //conversion mode is normally off and no conversion was started yet
+        init_MAX31856 &= triggerOneShot();
+        if(!init_MAX31856) {
+            INSTRUMENT_COUNT(init_failures);
+            return TC_RAW_INVALID;
+        }
+        INSTRUMENT_COUNT(stale_reads);
+        return prev_TC_raw;
     }
-    if(!init_MAX31856) return NAN;
     //calculate minimum wait time for conversions
     calculateDelayTime();
-    //initialize other info for the read functionality
-    uint32_t buf_read[3] = {0}, buf_write[3] = {ADDRESS_LTCBH_READ, ADDRESS_LTCBM_READ, ADDRESS_LTCBL_READ};
-    if(checkFaultsThermocoupleConnection()) //no faults with connection are present so continue on with normal read of temperature
+    uint32_t now = clock_us();
+    if (now - conversion_start_time < conversion_time) { //conversion still in progress, keep the last reading without using the bus
+        INSTRUMENT_COUNT(stale_reads);
+        return prev_TC_raw;
+    }
+    uint8_t buf_read[6] = {0};
+    readConversion(buf_read);
+    if (conversion_mode==0)     //start the next 1-shot conversion right away so it is ready for the next call
+        init_MAX31856 &= triggerOneShot();
+    else
+        conversion_start_time = now;
+    last_fault_sr = buf_read[5];
+    if(!buf_read[5]) //no faults with connection are present so continue on with normal read of temperature
     {
-        uint32_t tm = time(NULL)*1000000;
-        uint32_t duration = tm - lastReadTime;
-        lastReadTime = tm;
-        if (duration > conversion_time)
-        {
-            for(int i=0; i<3; i++) buf_read[i] = registerReadByte(buf_write[i]);
-            //Convert the registers contents into the correct value
-            int32_t temp  = ((buf_read[0] & 0xFF) << 0x18) + ((buf_read[1] & 0xFF) << 0x10) + ((buf_read[2] & 0xFF) << 0x08);   // LTCBH + LTCBM + LTCBL
-            return prev_TC = (temp >> 0x0D) * 0.0078125;
-        }
+        thermocouple_conversion_count++; //iterate the conversion count to speed up time in between future converions in always on mode
+        INSTRUMENT_COUNT(fresh_reads);
+        if(voltage_mode && software_tc) prev_CJ_raw = decodeCJRaw(&buf_read[0]);
+        prev_TC_raw = decodeTCRaw(&buf_read[2]);
+        adaptSampling(prev_TC_raw);
+        scheduleOpenCircuit(prev_TC_raw);
+        result_reported = deadbandPass(rawToTC(prev_TC_raw, prev_CJ_raw));
+        return prev_TC_raw;
     }
-    thermocouple_conversion_count++; //iterate the conversion count to speed up time in between future converions in always on mode
-    checkFaultsThermocoupleThresholds();  //print any faults to the terminal
-    return prev_TC;
+    logFaults(buf_read[5]);  //reported later by processFaultLog(), status register was already read with the temperature
+    INSTRUMENT_COUNT(fault_skips);
+    return prev_TC_raw;
 }
 
 
 //*****************************************************************************
 float MAX31856::readCJ()
 {
-    if(!init_MAX31856) return NAN;
-    uint32_t buf_read[2] = {0}, buf_write[2] = {ADDRESS_CJTH_READ, ADDRESS_CJTL_READ};
-    for(int i=0; i<2; i++) buf_read[i] = registerReadByte(buf_write[i]);
-    int16_t temp  = ((buf_read[0] & 0xFF) << 8) + (buf_read[1] & 0xFF); // CJTH + CJTL
-    return temp/256.0;
+    int16_t temp = readCJRaw();
+    return (temp == CJ_RAW_INVALID) ? NAN : cjRawToCelsius(temp);
+}
+
+
+//*****************************************************************************
+int16_t MAX31856::readCJRaw()
+{
+    BUS_METER(BUS_READ_CJ);
+    INSTRUMENT_LATENCY(cj_latency);
+    if(!init_MAX31856) {
+        INSTRUMENT_COUNT(init_failures);
+        return CJ_RAW_INVALID;
+    }
+    uint8_t buf_read[2] = {0};
+    registerReadBlock(ADDRESS_CJTH_READ, buf_read, 2); // CJTH + CJTL in a single frame
+    return decodeCJRaw(buf_read);
+}
+
+
+//*****************************************************************************
+MAX31856::Snapshot MAX31856::readAll()
+{
+    BUS_METER(BUS_READ_ALL);
+    result_reported = false;
+    Snapshot snapshot = {NAN, NAN, 0};
+    if(!init_MAX31856) return snapshot;
+    if (conversion_mode==0 && !one_shot_pending) {   //conversion mode is normally off and no conversion was started yet
+        init_MAX31856 &= triggerOneShot();
+        return lastSnapshot();
+    }
+    calculateDelayTime();
+    uint32_t now = clock_us();
+    if (now - conversion_start_time < conversion_time) //conversion still in progress, keep the last reading without using the bus
+        return lastSnapshot();
+    uint8_t buf_read[6] = {0};
+    registerReadBlock(ADDRESS_CJTH_READ, buf_read, 6); // CJTH + CJTL + LTCBH + LTCBM + LTCBL + SR in a single frame
+    if (conversion_mode==0)     //start the next 1-shot conversion so it is ready for the next snapshot
+        init_MAX31856 &= triggerOneShot();
+    else
+        conversion_start_time = now;
+    int32_t tc_raw = decodeTCRaw(&buf_read[2]);
+    int16_t cj_raw = decodeCJRaw(&buf_read[0]);
+    snapshot.cj = cjRawToCelsius(cj_raw);
+    snapshot.tc = rawToTC(tc_raw, cj_raw);
+    snapshot.sr = last_fault_sr = buf_read[5];
+    if(!snapshot.sr) { //keep the reading for readTC() only if no fault is present
+        thermocouple_conversion_count++;
+        prev_TC_raw = tc_raw;
+        prev_CJ_raw = cj_raw;
+        adaptSampling(tc_raw);
+        scheduleOpenCircuit(tc_raw);
+        result_reported = deadbandPass(snapshot.tc);
+    }
+    else
+        logFaults(snapshot.sr);
+    return snapshot;
+}
+
+
+//*****************************************************************************
+MAX31856::Snapshot MAX31856::lastSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.cj = (prev_CJ_raw == CJ_RAW_INVALID) ? NAN : cjRawToCelsius(prev_CJ_raw);
+    snapshot.tc = rawToTC(prev_TC_raw, prev_CJ_raw);
+    snapshot.sr = last_fault_sr;
+    return snapshot;
+}
+
+
+//*****************************************************************************
+void MAX31856::attachDataReady(PinName _drdy)
+{
+    delete drdy;
+    drdy = new InterruptIn(_drdy);
+    drdy->fall(callback(this, &MAX31856::conversionDone)); //DRDY goes low when a conversion result is available
+}
+
+
+//*****************************************************************************
+void MAX31856::attachConversionCallback(Callback<void(float)> _callback)
+{
+    conversion_callback = _callback;
+}
+
+
+//*****************************************************************************
+bool MAX31856::startConversion()
+{
+    BUS_METER(BUS_START_CONVERSION);
+    if(!init_MAX31856) return false;
+    conversion_ready = false;
+    if (conversion_mode==0) {   //means that the conversion mode is normally off
+        if(!triggerOneShot()) return false;
+    }
+    else
+        conversion_start_time = clock_us();
+    if(!drdy) {
+        calculateDelayTime();
+        conversion_timeout.attach_us(callback(this, &MAX31856::conversionDone), conversion_time);
+    }
+    return true;
+}
+
+
+//*****************************************************************************
+bool MAX31856::isReady() const
+{
+    return conversion_ready;
+}
+
+
+//*****************************************************************************
+bool MAX31856::poll()
+{
+    BUS_METER(BUS_POLL);
+    if(!conversion_ready) return false;
+    conversion_ready = false;
+    one_shot_pending = false;
+    uint8_t buf_read[6] = {0};
+    readConversion(buf_read);
+    return processConversion(buf_read);
+}
+
+
+#if DEVICE_SPI_ASYNCH
+//*****************************************************************************
+bool MAX31856::pollAsync(Callback<void()> _done)
+{
+    BUS_METER(BUS_POLL_ASYNC);
+    if(!init_MAX31856 || !conversion_ready || async_pending) return false;
+    spi.lock();         //only for the format, the frame ends in interrupt context where the lock cannot be released
+    applySpiFormat();
+    spi.unlock();
+    return startAsync(_done);
+}
+
+
+//*****************************************************************************
+bool MAX31856::startAsync(Callback<void()> _done)
+{
+    if(!init_MAX31856 || !conversion_ready || async_pending) return false;
+    MAX31856* owner = spiOwner();
+    if(!owner || owner->spi_hz != spi_hz) return false;   //the format cannot be changed from interrupt context, the result stays ready
+    uint8_t read_address;
+    conversionFrame(read_address, async_len);
+    memset(async_tx, 0, sizeof(async_tx));
+    async_tx[0] = read_address;
+    async_done = _done;
+    async_complete = false;
+    async_pending = true;
+    ncs=0;
+    if(spi.transfer(async_tx, async_len+1, async_rx, async_len+1, callback(this, &MAX31856::asyncTransferDone), SPI_EVENT_COMPLETE) != 0) {
+        ncs=1;              //SPI busy with another transfer, the result stays ready for the next attempt
+        async_pending = false;
+        return false;
+    }
+    spi_frame_count++;
+    spi_byte_count += async_len+1;
+    conversion_ready = false;
+    one_shot_pending = false;
+    return true;
+}
+
+
+//*****************************************************************************
+bool MAX31856::isTransferComplete() const
+{
+    return async_complete;
+}
+
+
+//*****************************************************************************
+bool MAX31856::completeAsync()
+{
+    if(!async_complete) return false;
+    async_complete = false;
+    async_pending = false;
+    uint8_t buf_read[6] = {0};
+    memcpy(&buf_read[async_tx[0] - ADDRESS_CJTH_READ], &async_rx[1], async_len); //same layout as readConversion()
+    return processConversion(buf_read);
+}
+
+
+//*****************************************************************************
+void MAX31856::asyncTransferDone(int)
+{
+    ncs=1;
+    async_complete = true;
+    if(async_done) async_done();
+}
+#endif
+
+
+//*****************************************************************************
+bool MAX31856::readSample(Sample& sample)
+{
+    BUS_METER(BUS_READ_SAMPLE);
+    if(!init_MAX31856 || !conversion_ready) return false;
+    conversion_ready = false;
+    one_shot_pending = false;
+    uint8_t buf_read[6] = {0};
+    registerReadBlock(ADDRESS_CJTH_READ, buf_read, 6); // CJTH + CJTL + LTCBH + LTCBM + LTCBL + SR in a single frame
+    sample.timestamp_us = clock_us();
+    sample.cj_raw = decodeCJRaw(&buf_read[0]);
+    sample.tc_raw = decodeTCRaw(&buf_read[2]);
+    sample.sr = last_fault_sr = buf_read[5];
+    if (conversion_mode==0 || !drdy)  //DRDY signals the next result by itself in normally on mode
+        startConversion();
+    return true;
+}
+
+
+//*****************************************************************************
+float MAX31856::getLastTC() const
+{
+    return rawToTC(prev_TC_raw, prev_CJ_raw);
+}
+
+
+//*****************************************************************************
+bool MAX31856::setAdaptiveSampling(const AdaptiveConfig* config)
+{
+    adaptive_enabled = false;
+    adaptive_fast = false;
+    if(!config) return true;
+    if(!(config->fast_rate > config->slow_rate) || config->slow_rate < 0.0f) return false;
+    if(!validAdaptiveSettings(config->fast_samples, config->fast_conversion_mode)
+       || !validAdaptiveSettings(config->slow_samples, config->slow_conversion_mode)) return false;
+    adaptive = *config;
+    adaptive_fast_rate = thresholdToRaw(config->fast_rate);    //°C/s to 1/128 °C per second, the comparisons of the hot path are integer only
+    adaptive_slow_rate = thresholdToRaw(config->slow_rate);
+    adaptive_switches = 0;
+    adaptive_pos = 0;
+    adaptive_count = 0;
+    beginConfig();
+    bool valid = setNumSamplesAvg(adaptive.slow_samples);
+    valid &= setConversionMode(adaptive.slow_conversion_mode);
+    valid &= commit();
+    if(!valid) return false;
+    one_shot_pending = false;
+    thermocouple_conversion_count = 0;
+    conversion_start_time = clock_us();
+    adaptive_enabled = true;
+    return true;
+}
+
+
+//*****************************************************************************
+bool MAX31856::isAdaptiveFast() const
+{
+    return adaptive_enabled && adaptive_fast;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getAdaptiveSwitchCount() const
+{
+    return adaptive_switches;
+}
+
+
+//*****************************************************************************
+bool MAX31856::validAdaptiveSettings(uint8_t samples_avg, uint8_t mode)
+{
+    switch(samples_avg)
+    {
+        case CR1_AVG_TC_SAMPLES_1: case CR1_AVG_TC_SAMPLES_2: case CR1_AVG_TC_SAMPLES_4: case CR1_AVG_TC_SAMPLES_8: case CR1_AVG_TC_SAMPLES_16:
+            break;
+        default:
+            return false;
+    }
+    return mode == CR0_CONV_MODE_NORMALLY_OFF || mode == CR0_CONV_MODE_NORMALLY_ON;
+}
+
+
+//*****************************************************************************
+int32_t MAX31856::thresholdToRaw(float value)
+{
+    value *= 128.0f;
+    if(value >= (float)MAX31856_RAW_THRESHOLD_MAX) return MAX31856_RAW_THRESHOLD_MAX;     //converting a float out of the int32_t range is undefined
+    if(value <= -(float)MAX31856_RAW_THRESHOLD_MAX) return -MAX31856_RAW_THRESHOLD_MAX;
+    return (int32_t)value;
+}
+
+
+//*****************************************************************************
+bool MAX31856::setDeadband(float threshold, uint32_t heartbeat_us)
+{
+    deadband_enabled = false;
+    if(!(threshold >= 0.0f)) return false;     //also rejects NAN
+    deadband_threshold = threshold;
+    deadband_heartbeat = heartbeat_us;
+    deadband_value = NAN;
+    deadband_invalid = false;
+    deadband_suppressed = 0;
+    deadband_reported = 0;
+    deadband_enabled = true;
+    return true;
+}
+
+
+//*****************************************************************************
+void MAX31856::clearDeadband()
+{
+    deadband_enabled = false;
+}
+
+
+//*****************************************************************************
+bool MAX31856::readTCChanged(float& temperature)
+{
+    temperature = readTC();
+    return result_reported;
+}
+
+
+//*****************************************************************************
+bool MAX31856::isResultReported() const
+{
+    return result_reported;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getSuppressedCount() const
+{
+    return deadband_suppressed;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getReportedCount() const
+{
+    return deadband_reported;
+}
+
+
+//*****************************************************************************
+bool MAX31856::setOpenCircuitSchedule(const OpenCircuitSchedule* schedule)
+{
+    oc_enabled = false;
+    oc_check_left = 0;
+    oc_draining = false;
+    if(!schedule) return true;
+    if(!openCircuitTime(schedule->detection) || !(schedule->step >= 0.0f) || !(schedule->noise >= 0.0f)
+       || !(schedule->min_temperature <= schedule->max_temperature)) return false;
+    oc_schedule = *schedule;
+    oc_step = thresholdToRaw(schedule->step);      //°C to 1/128 °C, the tests of the hot path are integer only
+    oc_noise = thresholdToRaw(schedule->noise);
+    oc_min = thresholdToRaw(schedule->min_temperature);
+    oc_max = thresholdToRaw(schedule->max_temperature);
+    oc_since_check = 0;
+    oc_history = 0;
+    oc_checks = 0;
+    oc_suspicions = 0;
+    if(!setOpenCircuitFaultDetection(oc_schedule.detection)) return false;
+    oc_check_left = MAX31856_OC_CHECK_RESULTS;
+    oc_enabled = true;
+    return true;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getOpenCircuitLatency() const
+{
+    uint32_t base = baseConversionTime(conversion_mode);
+    if(!oc_enabled) return oc_detect ? base + openCircuitTime(oc_detect) : 0;
+    if(!oc_schedule.interval) return 0;
+    //one cycle: interval results, the first one still slow from the previous check, then the results of the check
+    return (oc_schedule.interval + MAX31856_OC_CHECK_RESULTS)*base + (MAX31856_OC_CHECK_RESULTS + 1)*openCircuitTime(oc_schedule.detection);
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getAverageConversionTime() const
+{
+    uint32_t base = baseConversionTime(conversion_mode);
+    if(!oc_enabled) return base + openCircuitTime(oc_detect);
+    if(!oc_schedule.interval) return base;
+    return getOpenCircuitLatency() / (oc_schedule.interval + MAX31856_OC_CHECK_RESULTS);
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getOpenCircuitCheckCount() const
+{
+    return oc_checks;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856::getOpenCircuitSuspicionCount() const
+{
+    return oc_suspicions;
+}
+
+
+//*****************************************************************************
+void MAX31856::scheduleOpenCircuit(int32_t tc_raw)
+{
+    if(!oc_enabled) return;
+    if(oc_check_left) {     //result read with detection on and without fault
+        if(--oc_check_left) return;
+        oc_checks++;
+        oc_since_check = 0;
+        oc_draining = setOpenCircuitFaultDetection(CR0_OC_DETECT_DISABLED);
+        return;
+    }
+    oc_draining = false;
+    oc_since_check++;
+    bool suspicious = false;
+    if(oc_history >= 1 && oc_step) {
+        int32_t step = tc_raw - oc_prev[0];
+        suspicious |= (step < 0 ? -step : step) > oc_step;
+    }
+    if(oc_history >= 2 && oc_noise) {
+        int32_t noise = tc_raw - 2*oc_prev[0] + oc_prev[1];
+        suspicious |= (noise < 0 ? -noise : noise) > oc_noise;
+    }
+    if(oc_min < oc_max) suspicious |= tc_raw < oc_min || tc_raw > oc_max;
+    oc_prev[1] = oc_prev[0];
+    oc_prev[0] = tc_raw;
+    if(oc_history < 2) oc_history++;
+    if(suspicious) oc_suspicions++;
+    if(suspicious || (oc_schedule.interval && oc_since_check >= oc_schedule.interval)) {
+        if(setOpenCircuitFaultDetection(oc_schedule.detection)) oc_check_left = MAX31856_OC_CHECK_RESULTS;
+    }
+}
+
+
+//*****************************************************************************
+bool MAX31856::deadbandPass(float temperature)
+{
+    if(!deadband_enabled) return true;
+    uint32_t now = clock_us();
+    bool invalid = isnan(temperature);
+    bool report;
+    if(invalid) report = !deadband_invalid;    //a result turning invalid is always reported, NAN never becomes the reference
+    else report = deadband_invalid || isnan(deadband_value) || fabsf(temperature - deadband_value) > deadband_threshold;
+    if(report || (deadband_heartbeat && now - deadband_time >= deadband_heartbeat)) {
+        if(!invalid) deadband_value = temperature;
+        deadband_invalid = invalid;
+        deadband_time = now;
+        deadband_reported++;
+        return true;
+    }
+    deadband_suppressed++;
+    return false;
+}
+
+
+//*****************************************************************************
+void MAX31856::adaptSampling(int32_t tc_raw)
+{
+    if(!adaptive_enabled) return;
+    uint32_t now = clock_us();
+    adaptive_raw[adaptive_pos] = tc_raw;
+    adaptive_time[adaptive_pos] = now;
+    adaptive_pos = (adaptive_pos + 1) % MAX31856_ADAPTIVE_WINDOW;
+    if(adaptive_count < MAX31856_ADAPTIVE_WINDOW) adaptive_count++;
+    if(adaptive_count < MAX31856_ADAPTIVE_WINDOW) return;
+    int32_t delta = tc_raw - adaptive_raw[adaptive_pos];     //newest minus oldest of the window
+    uint32_t elapsed = now - adaptive_time[adaptive_pos];
+    if(!elapsed) return;
+    uint64_t rate = (uint64_t)(delta < 0 ? -delta : delta) * 1000000 / elapsed;
+    bool fast = adaptive_fast;
+    if(rate >= adaptive_fast_rate) fast = true;
+    else if(rate <= adaptive_slow_rate) fast = false;      //in between, keep the current settings
+    if(fast == adaptive_fast) return;
+    beginConfig();
+    bool valid = setNumSamplesAvg(fast ? adaptive.fast_samples : adaptive.slow_samples);
+    valid &= setConversionMode(fast ? adaptive.fast_conversion_mode : adaptive.slow_conversion_mode);
+    commit(false);      //CR0 + CR1 in a single frame, also writes a partial change so the device matches the cached copy
+    if(!valid) {
+        adaptive_enabled = false;
+        return;
+    }
+    adaptive_fast = fast;
+    adaptive_switches++;
+    adaptive_pos = 0;   //results of the old settings do not describe the new noise
+    adaptive_count = 0;
+    one_shot_pending = false;
+    thermocouple_conversion_count = 0;
+    conversion_start_time = now;
 }
 
+
 //*****************************************************************************
 uint8_t MAX31856::checkFaultsThermocoupleThresholds()
+{
+    BUS_METER(BUS_FAULTS);
+    return decodeFaultsThermocoupleThresholds(registerReadByte(ADDRESS_SR_READ)); //Read contents of fault status register
+}
+
+//*****************************************************************************
+uint8_t MAX31856::decodeFaultsThermocoupleThresholds(uint8_t fault_byte)
 {  
-    uint8_t fault_byte=registerReadByte(ADDRESS_SR_READ); //Read contents of fault status register
-    uint8_t temp[2], return_int;
-    for(int i=0; i<2; i++)
-        temp[i]=fault_byte;
-    
-    //Check if any of the faults for thermocouple connection are triggered
-    if      ((fault_byte&0x4C)==0) //means no fault is detected for thermocouple thresholds
-        return_int=0;
-    else {
-        if ((fault_byte&0x40)==0) {   //check if normal operation of thermocouple is true
-            if      (temp[0]&0x08) {
-                LOG("FAULT! Thermocouple temp is higher than the threshold that is set!\r\n");
-                return_int=1;
-            }
-            else if (temp[1]&0x04) {
-                LOG("FAULT! Thermocouple temp is lower than the threshold that is set!\r\n");
-                return_int=2;
-            }
-        }
-        else {                      //Thermocouples is operating outside of normal range
-            LOG("FAULT! Thermocouple temperature is out of range for specific type of thermocouple!\r\n");
-            if      (temp[0]&0x08) {
-                LOG("FAULT! Thermocouple temp is higher than the threshold that is set!\r\n");
-                return_int=4;
-            }
-            else if (temp[1]&0x04) {
-                LOG("FAULT! Thermocouple temp is lower than the threshold that is set!\r\n");
-                return_int=5;
-            }
-            else                    //no other faults are flagged besides unnatural operation
-                return_int=3; 
-        }
-    }
-    return return_int;
+    logFaults(fault_byte & (SR_TC_RANGE | SR_TC_HIGH | SR_TC_LOW));
+    if ((fault_byte & SR_TC_RANGE)==0)      //check if normal operation of thermocouple is true
+        return (fault_byte & SR_TC_HIGH) ? 1 : (fault_byte & SR_TC_LOW) ? 2 : 0;
+    return (fault_byte & SR_TC_HIGH) ? 4 : (fault_byte & SR_TC_LOW) ? 5 : 3;    //Thermocouples is operating outside of normal range
 }
 
 //*****************************************************************************
 uint8_t MAX31856::checkFaultsColdJunctionThresholds()
+{
+    BUS_METER(BUS_FAULTS);
+    return decodeFaultsColdJunctionThresholds(registerReadByte(ADDRESS_SR_READ)); //Read contents of fault status register
+}
+
+//*****************************************************************************
+uint8_t MAX31856::decodeFaultsColdJunctionThresholds(uint8_t fault_byte)
 {  
-    uint8_t fault_byte=registerReadByte(ADDRESS_SR_READ); //Read contents of fault status register
-    uint8_t temp[2], return_int;
-    for(int i=0; i<2; i++)
-        temp[i]=fault_byte;
-    
-    //Check if any of the faults for thermocouple connection are triggered
-    if ((fault_byte&0xB0)==0)  //means no fault is detected for cold junction thresholds
-        return_int=0;
-    else {
-        if ((fault_byte&0x80)==0) {   //check if normal operation of cold junction is true
-            if      (temp[0]&0x20) {
-                LOG("FAULT! Cold Junction temp is higher than the threshold that is set!\r\n");
-                return_int=1;
-            }
-            else if (temp[1]&0x10) {
-                LOG("FAULT! Cold Junction temp is lower than the threshold that is set!\r\n");
-                return_int=2;
-            }
-        }
-        else {                      //Cold Junction is operating outside of normal range
-            LOG("FAULT! Cold Junction temperature is out of range for specific type of thermocouple!\r\n");
-            if      (temp[0]&0x20) {
-                LOG("FAULT! Cold Junction temp is higher than the threshold that is set!\r\n");
-                return_int=4;
-            }
-            else if (temp[1]&0x10) {
-                LOG("FAULT! Cold Junction temp is lower than the threshold that is set!\r\n");
-                return_int=5;
-            }
-            else                    //no other faults are flagged besides unnatural operation
-                return_int=3;
-        }
-    }
-    return return_int;
+    logFaults(fault_byte & (SR_CJ_RANGE | SR_CJ_HIGH | SR_CJ_LOW));
+    if ((fault_byte & SR_CJ_RANGE)==0)      //check if normal operation of cold junction is true
+        return (fault_byte & SR_CJ_HIGH) ? 1 : (fault_byte & SR_CJ_LOW) ? 2 : 0;
+    return (fault_byte & SR_CJ_HIGH) ? 4 : (fault_byte & SR_CJ_LOW) ? 5 : 3;    //Cold Junction is operating outside of normal range
 }
 
 //*****************************************************************************
 bool MAX31856::checkFaultsThermocoupleConnection()
 {
-    return !registerReadByte(ADDRESS_SR_READ);  //Read contents of fault status register
+    BUS_METER(BUS_FAULTS);
+    uint8_t fault_byte = registerReadByte(ADDRESS_SR_READ);  //Read contents of fault status register
+    logFaults(fault_byte);
+    return !fault_byte;
+}
+
+//*****************************************************************************
+MAX31856::FaultStatus MAX31856::readFaultStatus()
+{
+    BUS_METER(BUS_FAULTS);
+    return decodeFaultStatus(registerReadByte(ADDRESS_SR_READ));
+}
+
+//*****************************************************************************
+MAX31856::FaultStatus MAX31856::getLastFaultStatus() const
+{
+    return decodeFaultStatus(last_fault_sr);
+}
+
+//*****************************************************************************
+MAX31856::FaultStatus MAX31856::decodeFaultStatus(uint8_t sr)
+{
+    FaultStatus status;
+    status.sr = sr;
+    status.cj_range = sr & SR_CJ_RANGE;
+    status.tc_range = sr & SR_TC_RANGE;
+    status.cj_high  = sr & SR_CJ_HIGH;
+    status.cj_low   = sr & SR_CJ_LOW;
+    status.tc_high  = sr & SR_TC_HIGH;
+    status.tc_low   = sr & SR_TC_LOW;
+    status.ovuv     = sr & SR_OVUV;
+    status.open     = sr & SR_OPEN;
+    return status;
+}
+
+//*****************************************************************************
+void MAX31856::attachFaultLog(Callback<void(const char*)> _sink, uint32_t min_interval_us)
+{
+    fault_log = _sink;
+    fault_log_interval = min_interval_us;
+}
+
+//*****************************************************************************
+bool MAX31856::attachFault(PinName _fault, Callback<void()> _callback)
+{
+    delete fault_pin;
+    fault_pin = NULL;
+    if(!registerReadWriteByte(ADDRESS_MASK_READ, ADDRESS_MASK_WRITE, MASK_CLEAR_BITS_0, 0)) return false; //an open thermocouple must drive FAULT
+    fault_callback = _callback;
+    fault_latched = false;
+    fault_pin = new InterruptIn(_fault);
+    fault_pin->fall(callback(this, &MAX31856::faultAsserted)); //FAULT is active low
+    return true;
+}
+
+//*****************************************************************************
+bool MAX31856::isFaultLatched() const
+{
+    return fault_latched;
+}
+
+//*****************************************************************************
+MAX31856::FaultStatus MAX31856::clearFault()
+{
+    BUS_METER(BUS_FAULTS);
+    FaultStatus status = readFaultStatus();
+    fault_latched = false;
+    setFaultStatusClear(CR0_FAULTCLR_RETURN_FAULTS_TO_ZERO);
+    return status;
+}
+
+//*****************************************************************************
+void MAX31856::faultAsserted()
+{
+    fault_latched = true;
+    if(fault_callback) fault_callback();
+}
+
+//*****************************************************************************
+void MAX31856::logFaults(uint8_t fault_byte)
+{
+    if(fault_byte) core_util_atomic_fetch_or_u32(&pending_faults, fault_byte);
+}
+
+//*****************************************************************************
+uint8_t MAX31856::processFaultLog()
+{
+    static const char* const messages[8] = {
+        "FAULT! Thermocouple is open!\r\n",
+        "FAULT! Thermocouple input is over or under voltage!\r\n",
+        "FAULT! Thermocouple temp is lower than the threshold that is set!\r\n",
+        "FAULT! Thermocouple temp is higher than the threshold that is set!\r\n",
+        "FAULT! Cold Junction temp is lower than the threshold that is set!\r\n",
+        "FAULT! Cold Junction temp is higher than the threshold that is set!\r\n",
+        "FAULT! Thermocouple temperature is out of range for specific type of thermocouple!\r\n",
+        "FAULT! Cold Junction temperature is out of range for specific type of thermocouple!\r\n",
+    };
+    if(!core_util_atomic_load_u32(&pending_faults)) return 0;
+    uint32_t now = clock_us();
+    if(fault_log_started && now - fault_log_time < fault_log_interval) return 0;   //rate limited, keep merging faults into the next report
+    fault_log_started = true;
+    fault_log_time = now;
+    uint8_t faults = core_util_atomic_exchange_u32(&pending_faults, 0);
+    for(int i=7; i>=0; i--) {
+        if(!(faults & (1 << i))) continue;
+        if(fault_log) fault_log(messages[i]);
+        else          LOG("%s", messages[i]);
+    }
+    return faults;
 }
 
 
@@ -192,6 +867,7 @@ bool MAX31856::checkFaultsThermocoupleConnection()
 //*****************************************************************************
 bool MAX31856::setConversionMode(uint8_t val) 
 {
+    BUS_METER(BUS_SET_CONVERSION_MODE);
     switch(val)
     {
         case CR0_CONV_MODE_NORMALLY_OFF: case CR0_CONV_MODE_NORMALLY_ON:
@@ -210,6 +886,7 @@ bool MAX31856::setConversionMode(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setOneShotMode(uint8_t val) 
 {
+    BUS_METER(BUS_SET_ONE_SHOT_MODE);
     switch(val)
     {
         case CR0_1_SHOT_MODE_NO_CONVERSION: case CR0_1_SHOT_MODE_ONE_CONVERSION:
@@ -227,9 +904,11 @@ bool MAX31856::setOneShotMode(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setOpenCircuitFaultDetection(uint8_t val) 
 {
+    BUS_METER(BUS_SET_OPEN_CIRCUIT_FAULT_DETECTION);
     switch(val)
     {
         case CR0_OC_DETECT_DISABLED: case CR0_OC_DETECT_ENABLED_R_LESS_5k: case CR0_OC_DETECT_ENABLED_TC_LESS_2ms: case CR0_OC_DETECT_ENABLED_TC_MORE_2ms:
+            oc_detect = val;
             return registerReadWriteByte(ADDRESS_CR0_READ, ADDRESS_CR0_WRITE, CR0_CLEAR_BITS_5_4, val);
         break;
         default:
@@ -244,6 +923,7 @@ bool MAX31856::setOpenCircuitFaultDetection(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setColdJunctionDisable(uint8_t val) 
 {
+    BUS_METER(BUS_SET_COLD_JUNCTION_DISABLE);
     switch(val)
     {
         case CR0_COLD_JUNC_ENABLE: case CR0_COLD_JUNC_DISABLE:
@@ -262,9 +942,11 @@ bool MAX31856::setColdJunctionDisable(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setFaultMode(uint8_t val) 
 {
+    BUS_METER(BUS_SET_FAULT_MODE);
     switch(val)
     {
         case CR0_FAULT_MODE_COMPARATOR: case CR0_FAULT_MODE_INTERUPT:
+            fault_mode = val;
             return registerReadWriteByte(ADDRESS_CR0_READ, ADDRESS_CR0_WRITE, CR0_CLEAR_BITS_2, val);
         break;
         default:
@@ -279,6 +961,7 @@ bool MAX31856::setFaultMode(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setFaultStatusClear(uint8_t val) 
 {
+    BUS_METER(BUS_SET_FAULT_STATUS_CLEAR);
     switch(val)
     {
         case CR0_FAULTCLR_DEFAULT_VAL: case CR0_FAULTCLR_RETURN_FAULTS_TO_ZERO:
@@ -296,6 +979,7 @@ bool MAX31856::setFaultStatusClear(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setEmiFilterFreq(uint8_t val) 
 {
+    BUS_METER(BUS_SET_EMI_FILTER_FREQ);
     switch(val)
     {
         case CR0_FILTER_OUT_60Hz: case CR0_FILTER_OUT_50Hz:
@@ -314,6 +998,7 @@ bool MAX31856::setEmiFilterFreq(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setNumSamplesAvg(uint8_t val) 
 {
+    BUS_METER(BUS_SET_NUM_SAMPLES_AVG);
     switch(val)
     {
         case CR1_AVG_TC_SAMPLES_1: case CR1_AVG_TC_SAMPLES_2: case CR1_AVG_TC_SAMPLES_4: case CR1_AVG_TC_SAMPLES_8: case CR1_AVG_TC_SAMPLES_16:
@@ -332,10 +1017,13 @@ bool MAX31856::setNumSamplesAvg(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setThermocoupleType(uint8_t val) 
 {
+    BUS_METER(BUS_SET_THERMOCOUPLE_TYPE);
     switch(val)
     {
         case CR1_TC_TYPE_B: case CR1_TC_TYPE_E: case CR1_TC_TYPE_J: case CR1_TC_TYPE_K: case CR1_TC_TYPE_N: case CR1_TC_TYPE_R: case CR1_TC_TYPE_S: case CR1_TC_TYPE_T: case CR1_TC_TYPE_VOLT_MODE_GAIN_8: case CR1_TC_TYPE_VOLT_MODE_GAIN_32:
             voltage_mode = ((val == CR1_TC_TYPE_VOLT_MODE_GAIN_8) || (val == CR1_TC_TYPE_VOLT_MODE_GAIN_32));
+            voltage_gain = (val == CR1_TC_TYPE_VOLT_MODE_GAIN_32) ? MAX31856_VOLTAGE_GAIN_32 : MAX31856_VOLTAGE_GAIN_8;
+            tc_type = val;
             return registerReadWriteByte(ADDRESS_CR1_READ, ADDRESS_CR1_WRITE, CR1_CLEAR_BITS_3_0, val);
         break;
         default:
@@ -350,6 +1038,7 @@ bool MAX31856::setThermocoupleType(uint8_t val)
 //*****************************************************************************
 bool MAX31856::setFaultMasks(uint8_t val, bool enable) 
 {
+    BUS_METER(BUS_SET_FAULT_MASKS);
     if(enable) val = 0;
     switch(val)
     {
@@ -383,6 +1072,7 @@ bool MAX31856::setFaultMasks(uint8_t val, bool enable)
 //******************************************************************************
 bool MAX31856::setFaultThresholds(uint8_t val, float temperature) 
 {
+    BUS_METER(BUS_SET_FAULT_THRESHOLDS);
     switch(val)
     {
         case MASK_CJ_FAULT_THRESHOLD_HIGH:
@@ -415,6 +1105,7 @@ bool MAX31856::setFaultThresholds(uint8_t val, float temperature)
 //******************************************************************************
 bool MAX31856::coldJunctionOffset(float temperature)
 {
+    BUS_METER(BUS_COLD_JUNCTION_OFFSET);
     if (temperature > 7.9375 || temperature < -8.0)
     {
         //LOG("Input value to offest the cold junction point is non valid. enter in value in range -8 to +7.9375\r\n");
@@ -429,6 +1120,9 @@ bool MAX31856::coldJunctionOffset(float temperature)
 //******************************************************************************
 void MAX31856::spiEnable() 
 {
+    spi.lock(); //other threads wait until the chip select is released, frames of different devices never interleave
+    applySpiFormat();
+    spi_frame_count++;
     ncs=0; //Set CS low to start transmission (interrupts conversion)
     return;
 }
@@ -438,15 +1132,55 @@ void MAX31856::spiEnable()
 void MAX31856::spiDisable() 
 {
     ncs=1; //Set CS high to stop transmission (restarts conversion)
+    spi.unlock();
     return;
 }
 
 
+//******************************************************************************
+void MAX31856::applySpiFormat() 
+{
+    MAX31856* owner = spiOwner();
+    if(!spi_shared && owner && owner->spi_hz == spi_hz) return;   //all MAX31856 use the same mode, nothing changed it since
+    spi.format(8,3);
+    spi.frequency(spi_hz);
+    if(spi_owner) core_util_atomic_store_ptr(&spi_owner->owner, this);
+}
+
+
+//******************************************************************************
+MAX31856::SpiOwner* MAX31856::spiOwnerEntry(SPI* _spi)
+{
+    for(int i=0; i<MAX31856_SPI_OBJECTS; i++) {
+        void* expected = NULL;
+        if(core_util_atomic_cas_ptr(&spi_owners[i].spi, &expected, _spi) || expected == _spi)
+            return &spi_owners[i];  //claimed now, or earlier for the same SPI object
+    }
+    return NULL;
+}
+
+
+//******************************************************************************
+MAX31856* MAX31856::spiOwner() const
+{
+    return spi_owner ? (MAX31856*)core_util_atomic_load_ptr(&spi_owner->owner) : NULL;
+}
+
+
+//******************************************************************************
+void MAX31856::releaseSpiOwner()
+{
+    void* expected = this;
+    if(spi_owner) core_util_atomic_cas_ptr(&spi_owner->owner, &expected, NULL);    //only if no other object applied its format since
+}
+
+
 //******************************************************************************
 bool MAX31856::registerReadWriteByte(uint8_t read_address, uint8_t write_address, int clear_bits, uint8_t val) 
 {   
-    //Read the current contents of a register
-    uint8_t buf_read = registerReadByte(read_address);
+    BUS_METER(BUS_REGISTER_ACCESS);
+    //Read the current contents of a register, configuration registers are taken from the cached copy
+    uint8_t buf_read = (read_address < CONFIG_REGISTER_COUNT) ? shadow_reg[read_address] : registerReadByte(read_address);
     
     //Modify contents pulled from the register 
     buf_read &= clear_bits; //Clear the contents of bits of parameter you are trying to clear for later or equal operation
@@ -455,10 +1189,13 @@ bool MAX31856::registerReadWriteByte(uint8_t read_address, uint8_t write_address
     
     //Write the updated byte to the register 
     registerWriteByte(write_address, val);
+    if(!verify_writes || config_staged) return true;
 
     //Read the current contents of a register
     buf_read = registerReadByte(read_address);
 
+    if(read_address == ADDRESS_CR0_READ) //the self clearing bits may already be back to zero
+        return (buf_read & ~CR0_SELF_CLEARING_BITS) == (val & ~CR0_SELF_CLEARING_BITS);
     return buf_read == val;
 }
 
@@ -466,49 +1203,357 @@ bool MAX31856::registerReadWriteByte(uint8_t read_address, uint8_t write_address
 //******************************************************************************
 bool MAX31856::registerWriteByte(uint8_t write_address, uint8_t val) 
 {   
-    //Write the updated byte to the register 
+    BUS_METER(BUS_REGISTER_ACCESS);
+    return registerWriteBlock(write_address, &val, 1);
+}
+
+//******************************************************************************
+bool MAX31856::registerWriteBlock(uint8_t write_address, const uint8_t* buf, uint8_t len) 
+{
+    BUS_METER(BUS_REGISTER_ACCESS);
+    uint8_t reg = write_address & 0x7F;
+    if(config_staged && reg + len <= CONFIG_REGISTER_COUNT) { //only update the cached copy, commit() writes it
+        for(uint8_t i=0; i<len; i++) shadow_reg[reg+i] = buf[i];
+        if(reg + len > staged_len) staged_len = reg + len;
+        if(reg <= ADDRESS_CR1_READ) decodeConfig();
+        return true;
+    }
+    
+    //Write the updated bytes to the registers
     spiEnable();
-    spi.write(write_address);
-    spi.write(val);
+    spiTransfer(write_address);
+    for(uint8_t i=0; i<len; i++) spiTransfer(buf[i]); //the MAX31856 auto-increments the address after each byte
     spiDisable();
+    
+    //Keep the cached copy up to date, the self clearing bits are not kept so they are not written again by the next setter
+    for(uint8_t i=0; i<len && reg+i<CONFIG_REGISTER_COUNT; i++) shadow_reg[reg+i] = buf[i];
+    if(reg == ADDRESS_CR0_READ) shadow_reg[ADDRESS_CR0_READ] &= ~CR0_SELF_CLEARING_BITS;
+    if(reg <= ADDRESS_CR1_READ) decodeConfig(); //keep the settings in line with a direct write of CR0 or CR1
     return true;
 }
 
 //******************************************************************************
 uint8_t MAX31856::registerReadByte(uint8_t read_address) 
 {
+    BUS_METER(BUS_REGISTER_ACCESS);
+    uint8_t buf_read = 0;
+    registerReadBlock(read_address, &buf_read, 1);
+    return buf_read;
+}
+
+//******************************************************************************
+bool MAX31856::registerReadBlock(uint8_t read_address, uint8_t* buf, uint8_t len) 
+{
+    BUS_METER(BUS_REGISTER_ACCESS);
     spiEnable();
-    spi.write(read_address);
-    uint8_t buf_read = spi.write(0);
+    spiTransfer(read_address);
+    for(uint8_t i=0; i<len; i++) buf[i] = spiTransfer(0); //the MAX31856 auto-increments the address after each byte
     spiDisable();
-    return buf_read;
+    return true;
+}
+
+//******************************************************************************
+bool MAX31856::sync()
+{
+    BUS_METER(BUS_CONFIG);
+    uint8_t buf_read[CONFIG_REGISTER_COUNT] = {0};
+    registerReadBlock(ADDRESS_CR0_READ, buf_read, CONFIG_REGISTER_COUNT);
+    if(buf_read[ADDRESS_CR1_READ] & CR1_RESERVED_BIT) return false; //nothing answered, keep the cached copy
+    memcpy(shadow_reg, buf_read, CONFIG_REGISTER_COUNT);
+    shadow_reg[ADDRESS_CR0_READ] &= ~CR0_SELF_CLEARING_BITS;
+    decodeConfig();
+    return true;
+}
+
+//******************************************************************************
+bool MAX31856::verifyConfig()
+{
+    BUS_METER(BUS_CONFIG);
+    uint8_t buf_read[CONFIG_REGISTER_COUNT] = {0};
+    registerReadBlock(ADDRESS_CR0_READ, buf_read, CONFIG_REGISTER_COUNT);
+    buf_read[ADDRESS_CR0_READ] &= ~CR0_SELF_CLEARING_BITS;
+    return memcmp(buf_read, shadow_reg, CONFIG_REGISTER_COUNT) == 0;
+}
+
+//******************************************************************************
+void MAX31856::setWriteVerification(bool enable)
+{
+    verify_writes = enable;
+}
+
+//******************************************************************************
+void MAX31856::beginConfig()
+{
+    config_staged = true;
+}
+
+//******************************************************************************
+bool MAX31856::commit(bool verify)
+{
+    BUS_METER(BUS_CONFIG);
+    config_staged = false;
+    if(staged_len) registerWriteBlock(ADDRESS_CR0_WRITE, shadow_reg, staged_len); //CR0 up to the last staged register in a single frame
+    staged_len = 0;
+    return verify ? verifyConfig() : true;
+}
+
+//******************************************************************************
+uint8_t MAX31856::spiTransfer(uint8_t val) 
+{
+    spi_byte_count++;
+    return spi.write(val);
+}
+
+//******************************************************************************
+uint32_t MAX31856::getSpiFrameCount() const
+{
+    return spi_frame_count;
+}
+
+//******************************************************************************
+uint32_t MAX31856::getSpiByteCount() const
+{
+    return spi_byte_count;
+}
+
+//******************************************************************************
+void MAX31856::resetSpiCounters()
+{
+    spi_frame_count = 0;
+    spi_byte_count = 0;
+}
+
+//******************************************************************************
+void MAX31856::setSpiShared(bool shared)
+{
+    spi_shared = shared;
+}
+
+//******************************************************************************
+bool MAX31856::setSpiFrequency(uint32_t hz)
+{
+    if(hz == 0 || hz > SPI_MAX_HZ) return false;
+    spi_hz = hz;
+    releaseSpiOwner();   //applied again by the next frame
+    return true;
+}
+
+#if MAX31856_BUS_STATS
+//******************************************************************************
+MAX31856::BusStats MAX31856::getBusStats(BusMethod method) const
+{
+    BusStats none = {0, 0, 0, 0};
+    return (method < BUS_METHOD_COUNT) ? bus_stats[method] : none;
+}
+
+//******************************************************************************
+void MAX31856::resetBusStats()
+{
+    memset(bus_stats, 0, sizeof(bus_stats));
+}
+#endif
+
+#if MAX31856_INSTRUMENTATION
+//******************************************************************************
+MAX31856::Instrumentation MAX31856::getInstrumentation() const
+{
+    return instrumentation;
+}
+
+//******************************************************************************
+void MAX31856::resetInstrumentation()
+{
+    memset(&instrumentation, 0, sizeof(instrumentation));
+}
+
+//******************************************************************************
+MAX31856::LatencyMeter::LatencyMeter(MAX31856* _device, uint32_t* _histogram) : device(_device), histogram(_histogram)
+{
+    start_time = device->clock_us();
+}
+
+//******************************************************************************
+MAX31856::LatencyMeter::~LatencyMeter()
+{
+    static const uint32_t limits[MAX31856_LATENCY_BUCKETS-1] = MAX31856_LATENCY_LIMITS_US;
+    uint32_t latency = device->clock_us() - start_time;
+    uint8_t bucket = 0;
+    while(bucket < MAX31856_LATENCY_BUCKETS-1 && latency >= limits[bucket]) bucket++;
+    histogram[bucket]++;
+}
+#endif
+
+#if MAX31856_BUS_STATS
+//******************************************************************************
+MAX31856::BusMeter::BusMeter(MAX31856* _device, BusMethod _method) : device(_device), method(_method)
+{
+    outermost = (device->bus_meter_depth++ == 0);
+    if(!outermost) return;
+    frames = device->spi_frame_count;
+    bytes = device->spi_byte_count;
+    start_time = device->clock_us();
+}
+
+//******************************************************************************
+MAX31856::BusMeter::~BusMeter()
+{
+    device->bus_meter_depth--;
+    if(!outermost) return;
+    BusStats& stats = device->bus_stats[method];
+    stats.calls++;
+    stats.frames += device->spi_frame_count - frames;
+    stats.bytes += device->spi_byte_count - bytes;
+    stats.time_us += device->clock_us() - start_time;
+}
+#endif
+
+//******************************************************************************
+int32_t MAX31856::decodeTCRaw(const uint8_t* buf)
+{
+    int32_t temp  = ((buf[0] & 0xFF) << 0x18) + ((buf[1] & 0xFF) << 0x10) + ((buf[2] & 0xFF) << 0x08);   // LTCBH + LTCBM + LTCBL
+    return temp >> 0x0D;
+}
+
+//******************************************************************************
+int16_t MAX31856::decodeCJRaw(const uint8_t* buf)
+{
+    return ((buf[0] & 0xFF) << 8) + (buf[1] & 0xFF); // CJTH + CJTL
+}
+
+//******************************************************************************
+void MAX31856::conversionFrame(uint8_t& read_address, uint8_t& len)
+{
+    bool read_sr = !fault_pin || fault_latched || !fault_pin->read();   //FAULT stays high while no unmasked fault is present, SR is known to be clear
+    if(voltage_mode && software_tc) {
+        read_address = ADDRESS_CJTH_READ;   // CJTH + CJTL + LTCBH + LTCBM + LTCBL (+ SR), the cold junction belongs to the same conversion
+        len = read_sr ? 6 : 5;
+    }
+    else {
+        read_address = ADDRESS_LTCBH_READ;  // LTCBH + LTCBM + LTCBL (+ SR)
+        len = read_sr ? 4 : 3;
+    }
+}
+
+//******************************************************************************
+void MAX31856::readConversion(uint8_t* buf)
+{
+    uint8_t read_address, len;
+    conversionFrame(read_address, len);
+    registerReadBlock(read_address, &buf[read_address - ADDRESS_CJTH_READ], len); //single frame, buf is laid out from CJTH
+}
+
+//******************************************************************************
+bool MAX31856::processConversion(const uint8_t* buf)
+{
+    result_reported = false;
+    last_fault_sr = buf[5];
+    if(buf[5]) {
+        logFaults(buf[5]);
+        return false;
+    }
+    thermocouple_conversion_count++;
+    if(voltage_mode && software_tc) prev_CJ_raw = decodeCJRaw(&buf[0]);
+    prev_TC_raw = decodeTCRaw(&buf[2]);
+    adaptSampling(prev_TC_raw);
+    scheduleOpenCircuit(prev_TC_raw);
+    float temperature = rawToTC(prev_TC_raw, prev_CJ_raw);
+    result_reported = deadbandPass(temperature);
+    if(conversion_callback && result_reported) conversion_callback(temperature);
+    return true;
+}
+
+//******************************************************************************
+float MAX31856::rawToTC(int32_t tc_raw, int16_t cj_raw) const
+{
+    if(tc_raw == TC_RAW_INVALID) return NAN;
+    if(!voltage_mode || !software_tc) return tcRawToCelsius(tc_raw);
+    if(cj_raw == CJ_RAW_INVALID) return NAN;
+    return MAX31856Linearization::compensate(software_tc, MAX31856Linearization::codeToMillivolts(tc_raw, voltage_gain), cjRawToCelsius(cj_raw));
+}
+
+//******************************************************************************
+void MAX31856::setSoftwareLinearization(const MAX31856Thermocouple* tc)
+{
+    software_tc = tc;
+    prev_CJ_raw = CJ_RAW_INVALID;
+}
+
+//******************************************************************************
+void MAX31856::setClock(uint32_t (*_clock_us)(void))
+{
+    clock_us = _clock_us;
+}
+
+//******************************************************************************
+bool MAX31856::triggerOneShot()
+{
+    thermocouple_conversion_count=0; //reset the conversion count back to zero to make sure minimum conversion time reflects one shot mode requirements
+    one_shot_pending = true;
+    conversion_start_time = clock_us();
+    return setOneShotMode(CR0_1_SHOT_MODE_ONE_CONVERSION); // turn on the one shot mode for singular conversion
+}
+
+//******************************************************************************
+void MAX31856::conversionDone()
+{
+    conversion_ready = true;
 }
 
 //******************************************************************************
 void MAX31856::calculateDelayTime() {
+    conversion_time = delayTime();
+}
+
+//*****************************************************************************
+uint32_t MAX31856::delayTime() const
+{
+    //open circuit detection lengthens every conversion while it is on, and the one in progress when a check switched it off
+    return baseConversionTime(conversion_mode && thermocouple_conversion_count) + openCircuitTime(oc_draining ? oc_schedule.detection : oc_detect);
+}
+
+//*****************************************************************************
+uint32_t MAX31856::baseConversionTime(bool continuous) const
+{
     uint32_t temp_int;
     
-    if (conversion_mode==0 || thermocouple_conversion_count==0) {
+    //integer arithmetic only, this runs on every read and the hot path must not pull in software float
+    if (!continuous) {
         if (filter_mode==0)  //60Hz
-            temp_int=82+(samples-1)*33.33f;
+            temp_int=82+(samples-1)*3333/100;
         else                 //50Hz
-            temp_int=98+(samples-1)*40.00f;
+            temp_int=98+(samples-1)*40;
     }
     else  { 
         if (filter_mode==0)  //60Hz
-            temp_int=82+(samples-1)*16.67f;
+            temp_int=82+(samples-1)*1667/100;
         else                //50Hz
-            temp_int=98+(samples-1)*20.00f;
+            temp_int=98+(samples-1)*20;
     }
     
     if (cold_junction_enabled==0) //cold junction is disabled enabling 25 millisecond faster conversion times
         temp_int=temp_int-25;
-    conversion_time=1000*temp_int; //set private member conversion time to calculated minimum wait time in microseconds
-    return;
+    return 1000*temp_int; //minimum wait time in microseconds
+}
+
+//*****************************************************************************
+uint32_t MAX31856::openCircuitTime(uint8_t detection)
+{
+    switch(detection)
+    {
+        case CR0_OC_DETECT_ENABLED_R_LESS_5k: case CR0_OC_DETECT_ENABLED_TC_LESS_2ms:
+            return MAX31856_OC_TIME_SHORT_US;
+        case CR0_OC_DETECT_ENABLED_TC_MORE_2ms:
+            return MAX31856_OC_TIME_LONG_US;
+        default:
+            return 0;
+    }
 }
 
 //*****************************************************************************
 MAX31856::~MAX31856(void) 
 {
-  //empty block
+    conversion_timeout.detach();
+    delete drdy;
+    delete fault_pin;
+    releaseSpiOwner();
 }
\ No newline at end of file
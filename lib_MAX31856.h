@@ -47,8 +47,8 @@
 
 #ifndef MAX31856_h
 #define MAX31856_h
-#include <ctime>
-#include "mbed.h"
+#include "lib_MAX31856_hal.h"
+#include "lib_MAX31856_linear.h"
 
 //*****************************************************************************
 //Define all the addresses of the registers in the MAX31856
@@ -169,6 +169,45 @@
 #define CJ_MAX_VAL_FAULT                   125
 #define CJ_MIN_VAL_FAULT                   -55
 
+#define TC_RAW_INVALID                     INT32_MIN   //returned by readTCRaw() when the object failed to initialize or no reading is available
+#define CJ_RAW_INVALID                     INT16_MIN   //returned by readCJRaw() when the object failed to initialize
+
+#define CONFIG_REGISTER_COUNT              10      //CR0 to CJTO, registers cached in the object
+#define CR0_SELF_CLEARING_BITS             0x42    //1-shot and FAULTCLR bits, cleared by the MAX31856 itself
+#define CR1_RESERVED_BIT                   0x80    //always reads 0 on the MAX31856, set when nothing drives MISO
+#define FAULT_LOG_DEFAULT_INTERVAL_US      1000000 //minimum time between two reports of processFaultLog()
+#define SPI_DEFAULT_HZ                     1000000 //SPI clock applied by the constructors, the mbed default
+#define SPI_MAX_HZ                         5000000 //fastest SPI clock of the MAX31856
+
+#ifndef MAX31856_INSTRUMENTATION
+#define MAX31856_INSTRUMENTATION           0       //1 adds the counters and latency histograms of getInstrumentation(), set it in the build flags
+#endif
+#ifndef MAX31856_BUS_STATS
+#define MAX31856_BUS_STATS                 0       //1 adds the per-function SPI bus statistics of getBusStats(), set it in the build flags
+#endif
+#ifndef MAX31856_SPI_OBJECTS
+#define MAX31856_SPI_OBJECTS               4       //SPI objects whose applied format is tracked, the format is applied on every frame of further ones
+#endif
+#define MAX31856_ADAPTIVE_WINDOW           4       //results over which adaptive sampling measures the rate of change
+#define MAX31856_RAW_THRESHOLD_MAX         0x40000000 //largest threshold in 1/128 °C, far above any 19 bit result or rate of change
+#define MAX31856_OC_CHECK_RESULTS          2       //results read with open circuit detection on per check, the first one may come from a conversion started before
+#define MAX31856_OC_TIME_SHORT_US          13000   //time added to a conversion by CR0_OC_DETECT_ENABLED_R_LESS_5k or CR0_OC_DETECT_ENABLED_TC_LESS_2ms
+#define MAX31856_OC_TIME_LONG_US           40000   //time added to a conversion by CR0_OC_DETECT_ENABLED_TC_MORE_2ms
+#define MAX31856_LATENCY_BUCKETS           8
+#define MAX31856_LATENCY_LIMITS_US         {10, 20, 50, 100, 200, 500, 1000}  //upper limits of the latency buckets, the last bucket has none
+
+//*****************************************************************************   
+///Bits of the fault status register
+//*****************************************************************************   
+#define SR_CJ_RANGE                        0x80    //cold junction outside -55 °C to +125 °C
+#define SR_TC_RANGE                        0x40    //thermocouple outside the range of its type
+#define SR_CJ_HIGH                         0x20
+#define SR_CJ_LOW                          0x10
+#define SR_TC_HIGH                         0x08
+#define SR_TC_LOW                          0x04
+#define SR_OVUV                            0x02    //input over or under voltage
+#define SR_OPEN                            0x01    //open thermocouple
+
 
 
 /**
@@ -185,7 +224,7 @@
  *
  * @code
  * #include "mbed.h"
- * #include "MAX31856.h"
+ * #include "lib_MAX31856.h"
  * 
  *
  * // Hardware serial port 
@@ -229,6 +268,119 @@ class MAX31856
 
 public:
 //*****************************************************************************    
+//Data types
+//*****************************************************************************
+    /** @brief Cold junction, thermocouple and fault status decoded together from one burst read of registers CJTH to SR */
+    struct Snapshot {
+        float tc;           ///< Thermocouple temperature in °C (NAN if the object failed to initialize)
+        float cj;           ///< Cold junction temperature in °C (NAN if the object failed to initialize)
+        uint8_t sr;         ///< Contents of the fault status register, 0 when no fault is present
+    };
+    
+    
+    /** @brief Timestamped raw conversion result, as queued in a MAX31856Ring for streaming */
+    struct Sample {
+        uint32_t timestamp_us;  ///< Time at which the result was read, from the clock set with setClock()
+        int32_t tc_raw;         ///< Thermocouple temperature, signed 19 bits in 1/128 °C (0.0078125 °C)
+        int16_t cj_raw;         ///< Cold junction temperature, signed in 1/256 °C (2 LSB always 0)
+        uint8_t sr;             ///< Contents of the fault status register, 0 when no fault is present
+    };
+    
+    
+    /** @brief The 8 bits of the fault status register, decoded from a single value with decodeFaultStatus() */
+    struct FaultStatus {
+        uint8_t sr;                 ///< Contents of the fault status register, 0 when no fault is present
+        bool cj_range : 1;          ///< Cold junction outside -55 °C to +125 °C
+        bool tc_range : 1;          ///< Thermocouple outside the range of its type
+        bool cj_high : 1;           ///< Cold junction above CJHF
+        bool cj_low : 1;            ///< Cold junction below CJLF
+        bool tc_high : 1;           ///< Thermocouple above LTHFT
+        bool tc_low : 1;            ///< Thermocouple below LTLFT
+        bool ovuv : 1;              ///< Input over or under voltage
+        bool open : 1;              ///< Open thermocouple
+        
+        /** @return true if any fault is present */
+        bool any() const { return sr != 0; }
+    };
+    
+    
+#if MAX31856_BUS_STATS
+    /** @brief Public functions whose use of the SPI bus is measured by getBusStats(), calls made from another measured function count for the outer one */
+    enum BusMethod {
+        BUS_READ_TC,                        ///< readTC(), readTCRaw(), readTCVoltage()
+        BUS_READ_CJ,                        ///< readCJ(), readCJRaw()
+        BUS_READ_ALL,                       ///< readAll()
+        BUS_START_CONVERSION,               ///< startConversion()
+        BUS_POLL,                           ///< poll()
+        BUS_POLL_ASYNC,                     ///< pollAsync(), the frame is counted when the transfer starts
+        BUS_READ_SAMPLE,                    ///< readSample()
+        BUS_FAULTS,                         ///< checkFaultsThermocoupleThresholds(), checkFaultsColdJunctionThresholds(), checkFaultsThermocoupleConnection(), readFaultStatus(), clearFault()
+        BUS_SET_CONVERSION_MODE,            ///< setConversionMode()
+        BUS_SET_ONE_SHOT_MODE,              ///< setOneShotMode()
+        BUS_SET_OPEN_CIRCUIT_FAULT_DETECTION,   ///< setOpenCircuitFaultDetection()
+        BUS_SET_COLD_JUNCTION_DISABLE,      ///< setColdJunctionDisable()
+        BUS_SET_FAULT_MODE,                 ///< setFaultMode()
+        BUS_SET_FAULT_STATUS_CLEAR,         ///< setFaultStatusClear()
+        BUS_SET_EMI_FILTER_FREQ,            ///< setEmiFilterFreq()
+        BUS_SET_NUM_SAMPLES_AVG,            ///< setNumSamplesAvg()
+        BUS_SET_THERMOCOUPLE_TYPE,          ///< setThermocoupleType()
+        BUS_SET_FAULT_MASKS,                ///< setFaultMasks()
+        BUS_SET_FAULT_THRESHOLDS,           ///< setFaultThresholds()
+        BUS_COLD_JUNCTION_OFFSET,           ///< coldJunctionOffset()
+        BUS_CONFIG,                         ///< begin(), sync(), verifyConfig(), commit()
+        BUS_REGISTER_ACCESS,                ///< registerReadWriteByte(), registerWriteByte(), registerReadByte(), registerWriteBlock(), registerReadBlock()
+        BUS_METHOD_COUNT                    ///< Number of measured functions, not a function
+    };
+    
+    
+#endif
+    /** @brief Averaging and conversion mode chosen by adaptive sampling from the rate of change of the thermocouple, see setAdaptiveSampling() */
+    struct AdaptiveConfig {
+        uint8_t fast_samples;           ///< CR1_AVG_TC_SAMPLES_x used while the temperature moves, usually CR1_AVG_TC_SAMPLES_1
+        uint8_t fast_conversion_mode;   ///< CR0_CONV_MODE_x used while the temperature moves, usually CR0_CONV_MODE_NORMALLY_ON
+        uint8_t slow_samples;           ///< CR1_AVG_TC_SAMPLES_x used at steady state, usually CR1_AVG_TC_SAMPLES_16
+        uint8_t slow_conversion_mode;   ///< CR0_CONV_MODE_x used at steady state
+        float fast_rate;                ///< Rate of change in °C/s at or above which the fast settings are applied
+        float slow_rate;                ///< Rate of change in °C/s at or below which the slow settings are applied, lower than fast_rate for hysteresis
+    };
+    
+    
+    /** @brief When the open circuit detection is switched on, see setOpenCircuitSchedule() */
+    struct OpenCircuitSchedule {
+        uint8_t detection;              ///< CR0_OC_DETECT_ENABLED_x used by the checks
+        uint16_t interval;              ///< A check every interval results, 0 for checks on suspicion only
+        float step;                     ///< Change in °C between consecutive results that triggers a check, 0 to ignore
+        float noise;                    ///< Second difference in °C of consecutive results (x[n] - 2x[n-1] + x[n-2]) that triggers a check, 0 to ignore
+        float min_temperature;          ///< Results below it in °C trigger a check
+        float max_temperature;          ///< Results above it in °C trigger a check, equal to min_temperature to ignore the range
+    };
+    
+    
+#if MAX31856_INSTRUMENTATION
+    /** @brief Counters of the reading functions and latency histograms, only with MAX31856_INSTRUMENTATION set to 1 */
+    struct Instrumentation {
+        uint32_t fresh_reads;       ///< readTC() calls that returned a new conversion result
+        uint32_t stale_reads;       ///< readTC() calls that returned the previous result because the conversion was in progress or was just triggered
+        uint32_t fault_skips;       ///< readTC() calls that kept the previous result because the fault status register was not clear
+        uint32_t init_failures;     ///< readTC() and readCJ() calls that returned NAN because the object failed to initialize
+        uint32_t tc_latency[MAX31856_LATENCY_BUCKETS];  ///< Durations of readTC(), bucket i counts the calls shorter than limit i of MAX31856_LATENCY_LIMITS_US
+        uint32_t cj_latency[MAX31856_LATENCY_BUCKETS];  ///< Durations of readCJ(), same buckets
+    };
+    
+    
+#endif
+#if MAX31856_BUS_STATS
+    /** @brief Use of the SPI bus accumulated over the calls of one function, only with MAX31856_BUS_STATS set to 1 */
+    struct BusStats {
+        uint32_t calls;         ///< Number of calls
+        uint32_t frames;        ///< SPI frames (chip select cycles)
+        uint32_t bytes;         ///< Bytes clocked on the SPI bus
+        uint32_t time_us;       ///< Time spent in the calls in microseconds, from the clock set with setClock()
+    };
+    
+    
+#endif
+//*****************************************************************************    
 //Constructor and Destructor for the class
 //***************************************************************************** 
     /**
@@ -239,6 +391,7 @@ public:
     * @param _fltr - Feature of the MAX31856 to filter out either 50Hz/60Hz from signal
     * @param _samples - How many samples are averaged for one conversion
     * @param _conversion_mode - Choose between always on and making conversions and off in between requests for a reading
+    * @note Returns right after configuring the device with begin(), readTC() reports NAN until isInitialized()
     */
     MAX31856(SPI& _spi, PinName _ncs, uint8_t _type=CR1_TC_TYPE_K, uint8_t _fltr=CR0_FILTER_OUT_60Hz, uint8_t _samples=CR1_AVG_TC_SAMPLES_1, uint8_t _conversion_mode=CR0_CONV_MODE_NORMALLY_OFF); 
     
@@ -247,22 +400,314 @@ public:
     ~MAX31856(void);
     
     
+//*****************************************************************************    
+//Initialization Functions
+//***************************************************************************** 
+    /** 
+    * @brief  Writes the whole cached configuration (CR0 to CJTO) in a single SPI frame, reads it back and restarts the first conversion,
+    *         returns without waiting for it, in normally off mode the first 1-shot conversion is triggered\n
+    *         CR0 and CR1 are rebuilt from the settings of the object, so a floating bus read by sync() is never written back.
+    *         Called by the constructors, call it again to reconfigure a device that was power cycled or failed to initialize.
+    *         Devices on one bus are started one after the other in a few SPI frames each and convert concurrently
+    * @return       \li 1 if the device matches the configuration
+    *               \li 0 otherwise, readTC() and readCJ() then return NAN
+    */
+    bool begin();
+    
+    
+    /** 
+    * @brief  Checks without bus access whether the device is ready: configured and past its first conversion, the first 1-shot
+    *         conversion in normally off mode
+    * @return       \li 1 if the device is ready
+    *               \li 0 if begin() failed or the first conversion is still in progress
+    */
+    bool isInitialized() const;
+    
+    
 //*****************************************************************************    
 //Temperature Functions
 //***************************************************************************** 
     /** 
-    * @brief  Requests read of the thermocouple temperature
-    * @return float of the converted thermocouple reading based on current configurations
+    * @brief  Requests read of the thermocouple temperature\n
+    *         The device is only read once the conversion time has elapsed since the last conversion started,
+    *         in normally off mode the next 1-shot conversion is triggered as soon as a result is read
+    * @return float of the converted thermocouple reading based on current configurations,
+    *         the last valid reading while a conversion is in progress or a fault is present.
+    *         In voltage mode with setSoftwareLinearization() the cold junction compensated temperature
     */
     float readTC();
     
     
+    /** 
+    * @brief  Requests read of the thermocouple voltage, the device must be configured in voltage mode
+    * @return thermocouple voltage in mV, NAN outside voltage mode or on failure. Same timing as readTC()
+    */
+    float readTCVoltage();
+    
+    
     /** 
     * @brief  Requests read of the cold junction temperature
     * @return float of the converted artificial cold junction reading based on current configurations
     */
     float readCJ();
-
+    
+    
+    /** 
+    * @brief  Integer version of readTC() for targets without FPU, readTC() is a wrapper around it
+    * @return signed 19 bits thermocouple temperature in 1/128 °C (0.0078125 °C), TC_RAW_INVALID instead of NAN
+    */
+    int32_t readTCRaw();
+    
+    
+    /** 
+    * @brief  Integer version of readCJ() for targets without FPU, readCJ() is a wrapper around it
+    * @return cold junction temperature in 1/256 °C (2 LSB always 0), CJ_RAW_INVALID instead of NAN
+    */
+    int16_t readCJRaw();
+    
+    
+    /** 
+    * @brief  Converts a raw thermocouple value of readTCRaw() into °C
+    * @param raw - Thermocouple temperature in 1/128 °C
+    * @return float of the thermocouple temperature in °C
+    */
+    static constexpr float tcRawToCelsius(int32_t raw) { return raw * 0.0078125f; }
+    
+    
+    /** 
+    * @brief  Converts a raw cold junction value of readCJRaw() into °C
+    * @param raw - Cold junction temperature in 1/256 °C
+    * @return float of the cold junction temperature in °C
+    */
+    static constexpr float cjRawToCelsius(int16_t raw) { return raw * 0.00390625f; }
+    
+    
+    /** 
+    * @brief  Converts a raw thermocouple value of readTCRaw() into milli °C without floating point
+    * @param raw - Thermocouple temperature in 1/128 °C
+    * @return thermocouple temperature in m°C, rounded toward minus infinity
+    */
+    static constexpr int32_t tcRawToMilliCelsius(int32_t raw) { return (raw * 1000) >> 7; }
+    
+    
+    /** 
+    * @brief  Converts a raw cold junction value of readCJRaw() into milli °C without floating point
+    * @param raw - Cold junction temperature in 1/256 °C
+    * @return cold junction temperature in m°C, rounded toward minus infinity
+    */
+    static constexpr int32_t cjRawToMilliCelsius(int16_t raw) { return (raw * 1000) >> 8; }
+    
+    
+    /** 
+    * @brief  Reads the cold junction temperature, the thermocouple temperature and the fault status register (registers 0x0A to 0x0F) in a single SPI frame
+    *          Like readTC() the bus is only used once the conversion is complete, before that the last valid reading is returned, and a
+    *          valid result goes through adaptive sampling, the open circuit schedule and the deadband
+    * @return Snapshot of the decoded registers, the thermocouple value is kept as last valid reading only when the fault status register is clear
+    */
+    Snapshot readAll();
+    
+    
+//*****************************************************************************    
+//Asynchronous Conversion Functions
+//*****************************************************************************
+    /** 
+    * @brief  Uses the DRDY output of the MAX31856 to detect the end of a conversion instead of a timer set to the conversion time
+    * @param _drdy - Pin connected to DRDY, its falling edge signals that a new conversion result is available
+    */
+    void attachDataReady(PinName _drdy);
+    
+    
+    /** 
+    * @brief  Registers a function called from poll() with the new thermocouple temperature each time a conversion result is read
+    *         and passes the deadband (setDeadband())
+    * @param _callback - Function taking the thermocouple temperature in °C
+    */
+    void attachConversionCallback(Callback<void(float)> _callback);
+    
+    
+    /** 
+    * @brief  Starts a conversion and returns immediately, a 1-shot conversion is triggered when the conversion mode is normally off\n
+    *         The end of the conversion is signaled by DRDY if attached, otherwise by a timer set to the conversion time
+    * @return       \li 1 on success   
+    *               \li 0 if the object failed to initialize or the 1-shot trigger failed
+    */
+    bool startConversion();
+    
+    
+    /** 
+    * @brief  Checks if the conversion started by startConversion() has completed, does not use the SPI bus
+    * @return       \li 1 if a conversion result is waiting to be read by poll()
+    *               \li 0 otherwise
+    */
+    bool isReady() const;
+    
+    
+    /** 
+    * @brief  Reads the conversion result if it is ready, keeps it as last valid reading of readTC() and calls the conversion callback\n
+    *         Call it from thread context, it never waits for the conversion
+    * @return       \li 1 if a new result was read without fault
+    *               \li 0 if no result is ready yet or the fault status register is not clear
+    */
+    bool poll();
+    
+    
+#if DEVICE_SPI_ASYNCH
+    /** 
+    * @brief  Same as poll() with an asynchronous SPI::transfer() (DMA where the target supports it), the CPU is free while the bytes are clocked\n
+    *         The chip select is asserted here and released from the transfer event. No other frame may be started on the SPI bus
+    *         until the transfer completed, completeAsync() then decodes the result
+    * @param _done - Function called from interrupt context when the transfer completed, may be empty
+    * @return       \li 1 if the transfer was started
+    *               \li 0 if no result is ready, a transfer of this object is still pending or the SPI is busy
+    */
+    bool pollAsync(Callback<void()> _done = Callback<void()>());
+    
+    
+    /** 
+    * @brief  Checks if the transfer started by pollAsync() completed, does not use the SPI bus
+    * @return       \li 1 if completeAsync() has a result to decode
+    *               \li 0 otherwise
+    */
+    bool isTransferComplete() const;
+    
+    
+    /** 
+    * @brief  Decodes the result of the transfer started by pollAsync() like poll(), call it from thread context
+    * @return       \li 1 if a new result was read without fault
+    *               \li 0 if the transfer is not complete or the fault status register is not clear
+    */
+    bool completeAsync();
+#endif
+    
+    
+    /** 
+    * @brief  Returns the last valid thermocouple reading without using the SPI bus
+    * @return float of the last thermocouple temperature read in °C, NAN if none was read yet
+    */
+    float getLastTC() const;
+    
+    
+    /** 
+    * @brief  Streaming read, reads the conversion result if it is ready as a timestamped raw sample and restarts the conversion\n
+    *         Meant to be called by a high priority thread pushing into a MAX31856Ring, with CR0_CONV_MODE_NORMALLY_ON and DRDY attached
+    *         the MAX31856 converts continuously and no register is written between samples
+    * @param sample - Receives CJTH to SR decoded as raw values, read in a single SPI frame
+    * @return       \li 1 if a new sample was read
+    *               \li 0 if no result is ready yet or the object failed to initialize
+    */
+    bool readSample(Sample& sample);
+    
+    
+//*****************************************************************************    
+//Adaptive Sampling Functions
+//*****************************************************************************
+    /** 
+    * @brief  Switches averaging and conversion mode automatically: few samples while the temperature moves, many at steady state\n
+    *         The rate of change is measured over the last MAX31856_ADAPTIVE_WINDOW results read by readTC() or poll().
+    *         Each switch writes CR0 and CR1 from the cached configuration in a single SPI frame, the rate is then measured again
+    *         from new results only. The device starts with the slow settings
+    * @param config - Settings and thresholds, copied, NULL to stop adapting (the current settings are kept)
+    * @return       \li 1 on success
+    *               \li 0 if a setting is invalid or fast_rate is not above slow_rate, adaptive sampling is then off
+    */
+    bool setAdaptiveSampling(const AdaptiveConfig* config);
+    
+    
+    /** 
+    * @return       \li 1 if adaptive sampling currently applies the fast settings
+    *               \li 0 for the slow settings or when adaptive sampling is off
+    */
+    bool isAdaptiveFast() const;
+    
+    
+    /** @return number of switches made by adaptive sampling since setAdaptiveSampling() */
+    uint32_t getAdaptiveSwitchCount() const;
+    
+    
+//*****************************************************************************    
+//Deadband Functions
+//*****************************************************************************
+    /** 
+    * @brief  Reports a new result only when it moved by more than a threshold since the last reported one, or when a heartbeat
+    *         interval expired\n
+    *         Applies to the conversion callback, the result callback of MAX31856Bus and readTCChanged(). Suppressed results
+    *         are still kept as last valid reading of readTC() and getLastTC(). The next result after this call is always reported,
+    *         so is a result turning NAN (outside the software linearization) or valid again
+    * @param threshold - Change in °C (unit of readTC()) that must be exceeded, 0 reports every change
+    * @param heartbeat_us - Longest time in microseconds without a report, 0 for no heartbeat
+    * @return       \li 1 on success
+    *               \li 0 if threshold is negative or NAN, the deadband is then off
+    */
+    bool setDeadband(float threshold, uint32_t heartbeat_us = 0);
+    
+    
+    /** @brief  Turns the deadband off, every new result is reported again */
+    void clearDeadband();
+    
+    
+    /** 
+    * @brief  Same as readTC() for a gateway forwarding the readings: tells if the value is a new result passing the deadband
+    * @param temperature - Receives the return value of readTC()
+    * @return       \li 1 if a new result was read and is reported (always the case for new results when the deadband is off)
+    *               \li 0 if the reading is the last one again or was suppressed by the deadband
+    */
+    bool readTCChanged(float& temperature);
+    
+    
+    /** 
+    * @return       \li 1 if the last result read by readTC(), readAll(), poll() or completeAsync() is reported
+    *               \li 0 if it was suppressed by the deadband, or if the last call did not read a new result
+    */
+    bool isResultReported() const;
+    
+    
+    /** @return number of new results suppressed by the deadband since setDeadband() */
+    uint32_t getSuppressedCount() const;
+    
+    
+    /** @return number of new results reported through the deadband since setDeadband() */
+    uint32_t getReportedCount() const;
+    
+    
+//*****************************************************************************    
+//Open Circuit Scheduling Functions
+//*****************************************************************************
+    /** 
+    * @brief  Keeps the open circuit detection off, which makes conversions faster, and switches it on only for checks: every Nth
+    *         result, or after a suspicious result (sudden step, noise jump, out of range)\n
+    *         Results are watched by readTC() and poll(). A check reads MAX31856_OC_CHECK_RESULTS results with detection on, an
+    *         open thermocouple then keeps the detection on and is reported by the fault status until it is repaired.
+    *         Calls of setOpenCircuitFaultDetection() are overridden by the next check. The first check starts at once.
+    *         getOpenCircuitLatency() and getAverageConversionTime() give the resulting trade-off
+    * @param schedule - Settings, copied, NULL to stop scheduling (the detection is left as it is)
+    * @return       \li 1 on success
+    *               \li 0 if a setting is invalid, scheduling is then off
+    */
+    bool setOpenCircuitSchedule(const OpenCircuitSchedule* schedule);
+    
+    
+    /** 
+    * @return worst case time in microseconds from a broken thermocouple to its report by the periodic checks, with the current
+    *         averaging, filter and conversion mode.
+    *         Without schedule, the time of one conversion if the detection is on, 0 if it is off or no periodic check is scheduled
+    */
+    uint32_t getOpenCircuitLatency() const;
+    
+    
+    /** 
+    * @return average time in microseconds between results including the slower conversions of the checks, 1000000 divided
+    *         by it is the throughput in results per second. Suspicion checks come on top
+    */
+    uint32_t getAverageConversionTime() const;
+    
+    
+    /** @return number of checks completed without open circuit since setOpenCircuitSchedule() */
+    uint32_t getOpenCircuitCheckCount() const;
+    
+    
+    /** @return number of suspicious results since setOpenCircuitSchedule() */
+    uint32_t getOpenCircuitSuspicionCount() const;
+    
     
 //*****************************************************************************    
 //Functions for register CR0
@@ -372,6 +817,16 @@ public:
     */
     bool setThermocoupleType(uint8_t val);
     
+    
+    /** 
+    * @brief  Linearizes the thermocouple in software while the device is in voltage mode\n
+    *         The cold junction temperature is read in the same frame as the voltage and compensated with the
+    *         NIST polynomials of the thermocouple, readTC(), readAll(), getLastTC() and the conversion callback
+    *         then report °C. Supports thermocouples the device does not linearize and a better accuracy than its ±0.7 °C
+    * @param tc - MAX31856Linearization::getThermocouple() or a custom description, NULL to report the scaled raw code again
+    */
+    void setSoftwareLinearization(const MAX31856Thermocouple* tc);
+    
 
 //*****************************************************************************    
 //Functions for register MASK
@@ -436,11 +891,77 @@ public:
     /** 
     * @brief  Check the fault stautus register to see if there is anything wrong with thermocouple connection to the MAX31856
     * @return       \li 1 if no faults are present
-    *               \li 0 if there is a fault and there needs to be information printed to the console to help diagnose issues
+    *               \li 0 if there is a fault, the fault is reported by the next processFaultLog() to help diagnose issues
     */
     bool checkFaultsThermocoupleConnection();
     
     
+    /** 
+    * @brief  Reads the fault status register once and decodes all of its bits
+    * @return decoded fault status, all clear if the read failed
+    */
+    FaultStatus readFaultStatus();
+    
+    
+    /** 
+    * @brief  Fault status read together with the last conversion result by readTC(), readAll(), poll() or readSample(), without bus access
+    * @return decoded fault status
+    */
+    FaultStatus getLastFaultStatus() const;
+    
+    
+    /** 
+    * @brief  Decodes a fault status register value
+    * @param sr - Contents of the fault status register
+    * @return decoded fault status
+    */
+    static FaultStatus decodeFaultStatus(uint8_t sr);
+    
+    
+    /** 
+    * @brief  Sets where processFaultLog() reports faults instead of printf()\n
+    *         Faults found while reading are only recorded, they are never printed from readTC() or the other reading functions
+    * @param _sink - Called once per fault message from processFaultLog(), an empty callback restores printf()
+    * @param min_interval_us - Minimum time between two reports, faults of the meantime are merged into the next report
+    */
+    void attachFaultLog(Callback<void(const char*)> _sink, uint32_t min_interval_us = FAULT_LOG_DEFAULT_INTERVAL_US);
+    
+    
+    /** 
+    * @brief  Reports the faults recorded since the last report, to be called from the main loop outside the sampling path
+    * @return fault status register bits that were reported, 0 if nothing was pending or the minimum interval did not elapse yet
+    */
+    uint8_t processFaultLog();
+    
+    
+    /** 
+    * @brief  Watches the FAULT output of the MAX31856, so conversion results are read without the fault status register while FAULT is high\n
+    *         A falling edge latches the fault until clearFault(), reads then include the fault status register again.
+    *         Works in both fault modes of setFaultMode(). Faults masked in the MASK register do not drive FAULT and are no longer
+    *         reported by readTC() or poll(). All faults are masked by default, so the open circuit fault is unmasked here, clear
+    *         the bits of the other faults to watch in the MASK register
+    * @param _fault - Pin connected to FAULT
+    * @param _callback - Function called from interrupt context when FAULT falls, may be empty
+    * @return       \li 1 on success
+    *               \li 0 if the open circuit fault could not be unmasked, the pin is then not used and SR is read with every result
+    */
+    bool attachFault(PinName _fault, Callback<void()> _callback = Callback<void()>());
+    
+    
+    /** 
+    * @brief  Checks the latched state of the FAULT output, without bus access
+    * @return true if FAULT fell since attachFault() or the last clearFault()
+    */
+    bool isFaultLatched() const;
+    
+    
+    /** 
+    * @brief  Reads the fault status register, clears the faults of the MAX31856 with FAULTCLR and the latched state of the FAULT output
+    * @return fault status read before clearing
+    */
+    FaultStatus clearFault();
+    
+    
 //*****************************************************************************    
 //General Functions
 //*****************************************************************************    
@@ -455,6 +976,8 @@ public:
     * @param clear_bits - Parameter that is 
     * @param val - Bitfield that contains bits related to function specific settings
     * @return       \li 1 on success
+    *               \li 0 if write verification is enabled and the value read back differs from the value written
+    * @note The contents of CR0 to CJTO are taken from the cached copy instead of being read from the device
     */
     bool registerReadWriteByte(uint8_t read_address, uint8_t write_address, int clear_bits, uint8_t val);
     
@@ -472,6 +995,16 @@ public:
     bool registerWriteByte(uint8_t write_address, uint8_t val);
     
     
+    /**
+    * @brief This function writes consecutive registers in a single SPI frame, the MAX31856 auto-increments the address after each byte
+    * @param write_address - Address of the first register to write
+    * @param buf - Bytes to write, must hold at least len bytes
+    * @param len - Number of consecutive registers to write
+    * @return   \li 1 on success
+    */
+    bool registerWriteBlock(uint8_t write_address, const uint8_t* buf, uint8_t len);
+    
+    
     /**
     * @brief This function is to read current contents of register by passing in the address of the read address and return contents of the register   
     * @param read_address - Address of register to read data from
@@ -480,6 +1013,16 @@ public:
     uint8_t registerReadByte(uint8_t read_address);
     
     
+    /**
+    * @brief This function reads the contents of consecutive registers in a single SPI frame, the MAX31856 auto-increments the address after each byte
+    * @param read_address - Address of the first register to read data from
+    * @param buf - Buffer receiving the contents of the registers, must hold at least len bytes
+    * @param len - Number of consecutive registers to read
+    * @return   \li 1 on success
+    */
+    bool registerReadBlock(uint8_t read_address, uint8_t* buf, uint8_t len);
+    
+    
     /**
     * @brief This function is to read current contents of register by passing in the address of the read address and return contents of the register   
     * @param temperature - Float of value to offest the value of the cold junction offset by (must be between -8°C to +7.9375°C)
@@ -488,8 +1031,147 @@ public:
     */
     bool coldJunctionOffset(float temperature);
     
+    
+    /**
+    * @brief Refreshes the cached copy of the configuration registers (CR0 to CJTO) from the MAX31856 in a single SPI frame\n
+    *        Setters modify the cached copy and only write to the device, call this if the device may have been changed by something else
+    * @return   \li 1 on success
+    *           \li 0 if nothing answered (the reserved bit of CR1 reads 1 on a floating bus), the cached copy is kept
+    */
+    bool sync();
+    
+    
+    /**
+    * @brief Reads back the configuration registers (CR0 to CJTO) in a single SPI frame and compares them with the cached copy
+    * @return   \li 1 if the device matches the cached configuration
+    *           \li 0 if any register differs
+    */
+    bool verifyConfig();
+    
+    
+    /**
+    * @brief Enables reading back every register after it is written by a setter, this costs one more SPI frame per setter
+    * @param enable \li 0 setters only write to the device (default)
+    *               \li 1 setters read the register back and return 0 on mismatch
+    */
+    void setWriteVerification(bool enable);
+    
+    
+    /**
+    * @brief Replaces the monotonic microsecond clock used to know when a conversion is complete (us_ticker_read() by default)
+    * @param _clock_us - Function returning a free running time in microseconds, wrapping around at 2^32
+    */
+    void setClock(uint32_t (*_clock_us)(void));
+    
+    
+    /**
+    * @brief Starts staging configuration changes, setters and threshold functions called until commit() only update the cached copy of CR0 to CJTO
+    * @note Do not read temperatures between beginConfig() and commit(), the 1-shot trigger of readTC() would be staged as well
+    */
+    void beginConfig();
+    
+    
+    /**
+    * @brief Writes all configuration changes staged since beginConfig() in a single auto-increment SPI frame starting at CR0,
+    *        then reads the configuration back in a single SPI frame to verify it
+    * @param verify \li 1 read the configuration back (default)
+    *               \li 0 only write, commit() then always returns 1
+    * @return   \li 1 if the device matches the staged configuration
+    *           \li 0 if any register differs
+    */
+    bool commit(bool verify = true);
+    
+    
+    /**
+    * @brief Number of SPI frames (chip select cycles) issued by this object since construction or the last call to resetSpiCounters()
+    * @return   \li count of SPI frames
+    */
+    uint32_t getSpiFrameCount() const;
+    
+    
+    /**
+    * @brief Number of bytes clocked on the SPI bus by this object since construction or the last call to resetSpiCounters()
+    * @return   \li count of SPI bytes
+    */
+    uint32_t getSpiByteCount() const;
+    
+    
+    /** @brief Resets the SPI frame and byte counters to zero */
+    void resetSpiCounters();
+    
+    
+    /**
+    * @brief Declares that drivers of other devices use the same SPI object\n
+    *        Every SPI frame holds SPI::lock() from chip select low to chip select high, so threads interleave whole frames safely.
+    *        The SPI mode is only applied again when the bus was last used by a MAX31856 on another SPI object, which misses
+    *        format changes made by other drivers on the same object
+    * @param shared \li 0 only MAX31856 objects use this SPI object (default)
+    *               \li 1 other drivers may change the format, the SPI mode is applied at the start of every frame
+    */
+    void setSpiShared(bool shared);
+    
+    
+    /**
+    * @brief Sets the SPI clock used by this object, applied at the start of its frames when the bus was last used at another clock
+    * @param hz - Clock in Hz, SPI_DEFAULT_HZ by default, up to SPI_MAX_HZ
+    * @return   \li 1 on success
+    *           \li 0 if hz is 0 or above SPI_MAX_HZ, the clock is not changed
+    */
+    bool setSpiFrequency(uint32_t hz);
+    
+    
+#if MAX31856_BUS_STATS
+    /**
+    * @brief Use of the SPI bus by a public function since construction or resetBusStats(), to size how many channels fit on one bus\n
+    *        For example getBusStats(BUS_READ_TC).time_us / getBusStats(BUS_READ_TC).calls is the bus time of one readTC()
+    * @param method - Measured function
+    * @return accumulated counters, all 0 for an invalid method
+    */
+    BusStats getBusStats(BusMethod method) const;
+    
+    
+    /** @brief Resets the counters of getBusStats() to zero */
+    void resetBusStats();
+    
+    
+#endif
+#if MAX31856_INSTRUMENTATION
+    /**
+    * @brief Copy of the counters and histograms since construction or resetInstrumentation(), to be exported periodically
+    * @return snapshot of the instrumentation
+    */
+    Instrumentation getInstrumentation() const;
+    
+    
+    /** @brief Resets the counters and histograms of getInstrumentation() to zero */
+    void resetInstrumentation();
+    
+    
+#endif
+
+protected:
+//*****************************************************************************    
+//Constructor for configurations checked at compile time
+//*****************************************************************************
+    /** @brief Contents of CR0 and CR1, computed and validated by the caller */
+    struct RegisterConfig {
+        uint8_t cr0;        ///< Value written to CR0
+        uint8_t cr1;        ///< Value written to CR1
+    };
+    
+    
+    /**
+    * @brief Constructor used by MAX31856T, CR0 and CR1 are written as given in a single frame without runtime parameter checks
+    * @param _spi - Reference to SPI object
+    * @param _ncs - Chip Select for SPI comunications with the oject
+    * @param config - Contents of CR0 and CR1
+    */
+    MAX31856(SPI& _spi, PinName _ncs, RegisterConfig config);
+    
 
 private:
+    ///Chains the transfers of its devices from interrupt context with startAsync()
+    friend class MAX31856Bus;
 
 //*****************************************************************************    
 //Private Functions
@@ -501,8 +1183,110 @@ private:
     /** @brief  Writes the chip seleect pin high to end SPI communications */
     void spiDisable();
     
+    /** @brief  Applies the SPI mode unless the last frame on this SPI object came from a MAX31856, call it with the SPI locked */
+    void applySpiFormat();
+    
+    /** @brief  Clocks one byte on the SPI bus and returns the byte received */
+    uint8_t spiTransfer(uint8_t val);
+    
+    /** @brief  Decodes thermocouple threshold faults from a fault status register value already read and records them for processFaultLog() */
+    uint8_t decodeFaultsThermocoupleThresholds(uint8_t fault_byte);
+    
+    /** @brief  Decodes cold junction threshold faults from a fault status register value already read and records them for processFaultLog() */
+    uint8_t decodeFaultsColdJunctionThresholds(uint8_t fault_byte);
+    
+    /** @brief  Converts the LTCBH, LTCBM and LTCBL bytes pointed to by buf into a signed 19 bits thermocouple temperature in 1/128 °C */
+    int32_t decodeTCRaw(const uint8_t* buf);
+    
+    /** @brief  Converts the CJTH and CJTL bytes pointed to by buf into a cold junction temperature in 1/256 °C */
+    int16_t decodeCJRaw(const uint8_t* buf);
+    
+    /** @brief  Records faults for the next processFaultLog(), safe from interrupt context */
+    void logFaults(uint8_t fault_byte);
+    
+    /** @brief  Triggers a 1-shot conversion and records its start time */
+    bool triggerOneShot();
+    
+    /** @brief  Signals the end of a conversion, called from interrupt context by DRDY or the conversion timer */
+    void conversionDone();
+    
+    /** @brief  Latches a fault, called from interrupt context by the falling edge of FAULT */
+    void faultAsserted();
+    
     /** @brief  Calculates minimum wait time for a conversion to take place */
     void calculateDelayTime();
+    
+    /** @brief  Minimum wait time in microseconds for the conversion in progress, without storing it */
+    uint32_t delayTime() const;
+    
+    /** @brief  Conversion time in microseconds without open circuit detection, of a 1-shot or first conversion or of a following continuous one */
+    uint32_t baseConversionTime(bool continuous) const;
+    
+    /** @brief  Time in microseconds added to a conversion by the open circuit detection setting of CR0 bits 5:4 */
+    static uint32_t openCircuitTime(uint8_t detection);
+    
+    /** @brief  Feeds a new valid result to the open circuit schedule and switches the detection on or off */
+    void scheduleOpenCircuit(int32_t tc_raw);
+    
+    /** @brief  Selects the registers of a conversion result: CJTH to SR in voltage mode, LTCBH to SR otherwise.
+    *          SR is left out while the FAULT output is attached and high */
+    void conversionFrame(uint8_t& read_address, uint8_t& len);
+    
+    /** @brief  Reads the registers of conversionFrame() into buf laid out as CJTH to SR (6 bytes), bytes that are not read are 0 */
+    void readConversion(uint8_t* buf);
+    
+    /** @brief  Keeps a result read by poll() or completeAsync() as last valid reading and calls the conversion callback */
+    bool processConversion(const uint8_t* buf);
+    
+#if DEVICE_SPI_ASYNCH
+    /** @brief  Starts the transfer of pollAsync() without locking the SPI bus, applying the format or metering, safe in interrupt context.
+    *          The caller applied the SPI format, returns 0 if the format of another object is applied */
+    bool startAsync(Callback<void()> _done);
+    
+    /** @brief  Releases the chip select at the end of the transfer of pollAsync(), called from interrupt context */
+    void asyncTransferDone(int);
+#endif
+    
+    /** @brief  Feeds a new valid result to adaptive sampling and switches the settings when the rate of change crosses a threshold,
+    *          turns adaptive sampling off if a setting is refused */
+    void adaptSampling(int32_t tc_raw);
+    
+    /** @brief  Checks an averaging and conversion mode of AdaptiveConfig like setNumSamplesAvg() and setConversionMode() */
+    static bool validAdaptiveSettings(uint8_t samples_avg, uint8_t mode);
+    
+    /** @brief  Converts a user threshold in °C (or °C/s) into 1/128 °C for the integer tests of the hot path, clamped to
+    *          +-MAX31856_RAW_THRESHOLD_MAX so that huge or infinite settings do not overflow the cast */
+    static int32_t thresholdToRaw(float value);
+    
+    /** @brief  Applies the deadband to a new result, updates the counters and returns 1 if the result is reported */
+    bool deadbandPass(float temperature);
+    
+    /** @brief  Converts raw readings into °C, applies the software linearization in voltage mode when it is set */
+    float rawToTC(int32_t tc_raw, int16_t cj_raw) const;
+    
+    /** @brief  Sets the cached configuration fields (conversion mode, filter, samples, type...) from the cached CR0 and CR1 */
+    void decodeConfig();
+    
+    /** @brief  Rebuilds the cached CR0 and CR1 from the cached configuration fields */
+    void encodeConfig();
+    
+    /** @brief Object whose SPI format was applied last on an SPI object, entries are claimed once and never freed */
+    struct SpiOwner {
+        void* volatile spi;         ///< SPI object of the entry, NULL while the entry is free
+        void* volatile owner;       ///< MAX31856 whose format was applied last, NULL when unknown
+    };
+    
+    /** @brief  Finds or claims the entry of spi_owners of an SPI object, safe against threads claiming entries for other SPI objects */
+    static SpiOwner* spiOwnerEntry(SPI* _spi);
+    
+    /** @brief  Object whose SPI format was applied last on the SPI object, NULL if unknown */
+    MAX31856* spiOwner() const;
+    
+    /** @brief  Forgets that the format of this object is applied, so the next frame applies it again */
+    void releaseSpiOwner();
+    
+    /** @brief  Snapshot of the last valid reading returned by readAll() while no new conversion is ready */
+    Snapshot lastSnapshot() const;
        
     
 //*****************************************************************************    
@@ -517,12 +1301,30 @@ private:
     /// Chip select pin for SPI communications
     DigitalOut ncs;
     
+    /// 1=drivers of other devices use the same SPI object
+    bool spi_shared = false;
+    
+    /// Object whose SPI format was applied last on each SPI object
+    static SpiOwner spi_owners[MAX31856_SPI_OBJECTS];
+    
+    /// Entry of spi_owners of the SPI object, NULL if the table is full
+    SpiOwner* spi_owner = NULL;
+    
     /// Number of samples the thermocouple is configured to average
     uint8_t samples;
     
+    /// Thermocouple type or voltage mode of CR1 bits 3:0
+    uint8_t tc_type = CR1_TC_TYPE_K;
+    
     /// 0=thermocouple is set to one of 8 thermocouple types   and   1=Thermocouple is configured to report in voltage mode
     bool voltage_mode;
     
+    /// Gain of the voltage mode, MAX31856_VOLTAGE_GAIN_8 or MAX31856_VOLTAGE_GAIN_32
+    uint8_t voltage_gain = MAX31856_VOLTAGE_GAIN_8;
+    
+    /// Thermocouple linearized in software in voltage mode, NULL when not used
+    const MAX31856Thermocouple* software_tc = NULL;
+    
     /// 0=60Hz   and   1=50Hz
     bool filter_mode;
     
@@ -530,22 +1332,227 @@ private:
     bool conversion_mode;
     
     /// 0=cold junction is disabled   and   1=cold junction is enabled
-    bool cold_junction_enabled;
+    bool cold_junction_enabled = true;
+    
+    /// Fault mode of CR0 bit 2, CR0_FAULT_MODE_COMPARATOR or CR0_FAULT_MODE_INTERUPT
+    uint8_t fault_mode = CR0_FAULT_MODE_COMPARATOR;
     
-    ///Define a return val for all boolean functions
-    bool return_val;
+    ///Time in microseconds at which begin() configured the device
+    uint32_t begin_time = 0;
     
-    ///Used to figure out when a new conversion is ready to go
-    uint32_t lastReadTime;
+    ///Time in microseconds at which the current conversion started, used to figure out when a new conversion is ready to go
+    uint32_t conversion_start_time = 0;
+    
+    ///Monotonic microsecond clock used for conversion timing
+    uint32_t (*clock_us)(void) = us_ticker_read;
+    
+    ///1=a 1-shot conversion was triggered and its result was not read yet
+    bool one_shot_pending = false;
     
     ///How many conversions have taken place since conversion mode was switched into auto mode
     ///Also this value should be 0 if the mode is in oneshot mode
-    uint32_t thermocouple_conversion_count; 
+    uint32_t thermocouple_conversion_count = 0;
     
     ///time in milliseconds that is needed minimum for a new conversion to take place
     uint32_t conversion_time;
 
-    float prev_TC = NAN;
+    ///Last valid thermocouple reading in 1/128 °C, TC_RAW_INVALID until the first reading
+    int32_t prev_TC_raw = TC_RAW_INVALID;
+    
+    ///Cold junction reading of the same frame as prev_TC_raw in voltage mode, in 1/256 °C
+    int16_t prev_CJ_raw = CJ_RAW_INVALID;
+    
+    ///FAULT input used to skip the fault status register while no fault is present, NULL when not used
+    InterruptIn* fault_pin = NULL;
+    
+    ///Called from interrupt context when FAULT falls
+    Callback<void()> fault_callback;
+    
+    ///1=FAULT fell since the last clearFault()
+    volatile bool fault_latched = false;
+    
+#if DEVICE_SPI_ASYNCH
+    ///Address byte followed by the dummy bytes of the transfer of pollAsync()
+    uint8_t async_tx[7];
+    
+    ///Bytes received by the transfer of pollAsync(), the first one is clocked during the address
+    uint8_t async_rx[7];
+    
+    ///Number of registers read by the transfer of pollAsync()
+    uint8_t async_len = 0;
+    
+    ///1=pollAsync() started a transfer that completeAsync() did not decode yet
+    bool async_pending = false;
+    
+    ///1=the transfer of pollAsync() completed
+    volatile bool async_complete = false;
+    
+    ///Called from interrupt context when the transfer of pollAsync() completed
+    Callback<void()> async_done;
+#endif
+    
+    ///Settings of adaptive sampling
+    AdaptiveConfig adaptive;
+    
+    ///Thresholds of adaptive sampling in 1/128 °C per second
+    uint32_t adaptive_fast_rate, adaptive_slow_rate;
+    
+    ///1=adaptive sampling is on
+    bool adaptive_enabled = false;
+    
+    ///1=the fast settings are applied
+    bool adaptive_fast = false;
+    
+    ///Last results and the times they were read, oldest at adaptive_pos once adaptive_count reached MAX31856_ADAPTIVE_WINDOW
+    int32_t adaptive_raw[MAX31856_ADAPTIVE_WINDOW];
+    uint32_t adaptive_time[MAX31856_ADAPTIVE_WINDOW];
+    uint8_t adaptive_pos = 0;
+    uint8_t adaptive_count = 0;
+    
+    ///Number of switches since setAdaptiveSampling()
+    uint32_t adaptive_switches = 0;
+    
+    ///Open circuit detection setting of CR0 bits 5:4, included in the conversion time
+    uint8_t oc_detect = CR0_OC_DETECT_DISABLED;
+    
+    ///Settings of the open circuit schedule, thresholds in 1/128 °C
+    OpenCircuitSchedule oc_schedule;
+    int32_t oc_step, oc_noise, oc_min, oc_max;
+    
+    ///1=the open circuit schedule is on
+    bool oc_enabled = false;
+    
+    ///Results left to read with detection on before the check completes, 0 when no check runs
+    uint8_t oc_check_left = 0;
+    
+    ///1=a check just switched the detection off, the conversion in progress still takes the detection time
+    bool oc_draining = false;
+    
+    ///Results since the last check
+    uint32_t oc_since_check = 0;
+    
+    ///Last two results, newest first, for the step and noise tests, and how many of them are valid
+    int32_t oc_prev[2];
+    uint8_t oc_history = 0;
+    
+    ///Counters of the open circuit schedule
+    uint32_t oc_checks = 0;
+    uint32_t oc_suspicions = 0;
+    
+    ///Change to exceed and longest interval between reports of the deadband
+    float deadband_threshold = 0.0f;
+    uint32_t deadband_heartbeat = 0;
+    
+    ///1=the deadband is on
+    bool deadband_enabled = false;
+    
+    ///Last valid reported result and the time of the last report, NAN until a valid result is reported
+    float deadband_value = NAN;
+    uint32_t deadband_time = 0;
+    
+    ///1=the last report was NAN, the next valid result is reported
+    bool deadband_invalid = false;
+    
+    ///Counters of the deadband since setDeadband()
+    uint32_t deadband_suppressed = 0;
+    uint32_t deadband_reported = 0;
+    
+    ///1=the last new result passed the deadband, see isResultReported()
+    bool result_reported = false;
+    
+    ///Fault status register read with the last conversion result
+    uint8_t last_fault_sr = 0;
+    
+    ///Fault status register bits recorded since the last report of processFaultLog()
+    volatile uint32_t pending_faults = 0;
+    
+    ///Destination of processFaultLog(), printf() when empty
+    Callback<void(const char*)> fault_log;
+    
+    ///Minimum time between two reports of processFaultLog() in microseconds
+    uint32_t fault_log_interval = FAULT_LOG_DEFAULT_INTERVAL_US;
+    
+    ///Time of the last report of processFaultLog()
+    uint32_t fault_log_time = 0;
+    
+    ///1=processFaultLog() reported at least once, fault_log_time is valid
+    bool fault_log_started = false;
+    
+    ///DRDY input used to detect the end of conversions, NULL when the conversion timer is used instead
+    InterruptIn* drdy = NULL;
+    
+    ///Timer signaling the end of a conversion started by startConversion() when DRDY is not attached
+    Timeout conversion_timeout;
+    
+    ///Function called from poll() with each new thermocouple temperature
+    Callback<void(float)> conversion_callback;
+    
+    ///1=a conversion result is waiting to be read by poll(), set from interrupt context
+    volatile bool conversion_ready = false;
+    
+    ///Cached copy of the configuration registers CR0 to CJTO, indexed by read address, power on defaults until sync() reads the device
+    uint8_t shadow_reg[CONFIG_REGISTER_COUNT] = {0x00, 0x03, 0xFF, 0x7F, 0xC0, 0x7F, 0xFF, 0x80, 0x00, 0x00};
+    
+    ///0=setters only write to the device   and   1=setters read back the register after writing it
+    bool verify_writes = false;
+    
+    ///1=configuration writes are only applied to the cached copy until commit() is called
+    bool config_staged = false;
+    
+    ///Number of cached registers, counted from CR0, that changed since beginConfig()
+    uint8_t staged_len = 0;
+    
+    ///Number of SPI frames (chip select cycles) issued, used to measure bus usage
+    uint32_t spi_frame_count = 0;
+    
+    ///Number of bytes clocked on the SPI bus, used to measure bus usage
+    uint32_t spi_byte_count = 0;
+    
+    ///SPI clock of this object in Hz
+    uint32_t spi_hz = SPI_DEFAULT_HZ;
+    
+#if MAX31856_BUS_STATS
+    ///Use of the SPI bus of each measured public function
+    BusStats bus_stats[BUS_METHOD_COUNT] = {};
+    
+    ///Number of measured functions in progress, only the outermost one records
+    uint8_t bus_meter_depth = 0;
+    
+    
+#endif
+#if MAX31856_INSTRUMENTATION
+    ///Counters and histograms of getInstrumentation()
+    Instrumentation instrumentation = {};
+    
+    
+    /** @brief Adds the time from its construction to its destruction to a latency histogram */
+    class LatencyMeter
+    {
+    public:
+        LatencyMeter(MAX31856* _device, uint32_t* _histogram);
+        ~LatencyMeter();
+    private:
+        MAX31856* device;
+        uint32_t* histogram;
+        uint32_t start_time;
+    };
+    
+    
+#endif
+#if MAX31856_BUS_STATS
+    /** @brief Records the SPI frames, bytes and time of a public function into bus_stats from its construction to its destruction */
+    class BusMeter
+    {
+    public:
+        BusMeter(MAX31856* _device, BusMethod _method);
+        ~BusMeter();
+    private:
+        MAX31856* device;
+        BusMethod method;
+        bool outermost;
+        uint32_t frames, bytes, start_time;
+    };
+#endif
 };
 
 #endif  /* __MAX31856_H_ */
\ No newline at end of file
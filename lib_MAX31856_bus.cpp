@@ -0,0 +1,206 @@
+/******************************************************************//**
+* @file lib_MAX31856_bus.cpp
+*
+* @version 1.0
+*
+* @brief Source file for MAX31856Bus class
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "lib_MAX31856_bus.h"
+
+//*****************************************************************************
+MAX31856Bus::MAX31856Bus(uint32_t _stagger_us) : stagger_us(_stagger_us)
+{
+    for(int i=0; i<MAX31856_BUS_MAX_DEVICES; i++) {
+        devices[i] = NULL;
+        results[i] = NAN;
+        sample_count[i] = 0;
+        started[i] = false;
+    }
+}
+
+
+//*****************************************************************************
+bool MAX31856Bus::addDevice(MAX31856* device)
+{
+    if(running || device_count >= MAX31856_BUS_MAX_DEVICES) return false;
+    devices[device_count++] = device;
+    return true;
+}
+
+
+//*****************************************************************************
+void MAX31856Bus::start()
+{
+    for(uint8_t i=0; i<device_count; i++) {
+        results[i] = NAN;
+        sample_count[i] = 0;
+        started[i] = false;
+    }
+    start_time = clock_us();
+    running = true;
+}
+
+
+//*****************************************************************************
+void MAX31856Bus::stop()
+{
+    running = false;
+}
+
+
+//*****************************************************************************
+uint8_t MAX31856Bus::poll()
+{
+    if(!running) return 0;
+    uint8_t harvested = 0;
+    uint32_t elapsed = clock_us() - start_time;
+    for(uint8_t i=0; i<device_count; i++) {
+        if(!started[i]) {           //first conversion of the channel is started once its stagger slot is reached
+            if(elapsed >= i*stagger_us) started[i] = devices[i]->startConversion();
+            continue;
+        }
+        if(!devices[i]->isReady()) continue;
+        bool valid = devices[i]->poll();   //one SPI frame to read the result
+        devices[i]->startConversion();     //restart right away so the channel keeps converting while the others are read
+        if(valid) {
+            results[i] = devices[i]->getLastTC();
+            sample_count[i]++;
+            harvested++;
+            if(result_callback && devices[i]->isResultReported()) result_callback(i, results[i]);
+        }
+    }
+    return harvested;
+}
+
+
+#if DEVICE_SPI_ASYNCH
+//*****************************************************************************
+uint8_t MAX31856Bus::pollAsync()
+{
+    if(!running || core_util_atomic_load_u32(&queue_pos) < queue_len) return 0;  //frames still clocking, nothing to do for the CPU
+    uint8_t harvested = 0;
+    for(uint8_t q=0; q<queue_len; q++) {
+        uint8_t i = queue[q];
+        if(!devices[i]->isTransferComplete()) continue;    //transfer could not start, the result is queued again below
+        bool valid = devices[i]->completeAsync();
+        devices[i]->startConversion();     //restart right away so the channel keeps converting while the others are read
+        if(valid) {
+            results[i] = devices[i]->getLastTC();
+            sample_count[i]++;
+            harvested++;
+            if(result_callback && devices[i]->isResultReported()) result_callback(i, results[i]);
+        }
+    }
+    queue_len = 0;
+    uint32_t elapsed = clock_us() - start_time;
+    for(uint8_t i=0; i<device_count; i++) {
+        if(!started[i]) {           //first conversion of the channel is started once its stagger slot is reached
+            if(elapsed >= i*stagger_us) started[i] = devices[i]->startConversion();
+            continue;
+        }
+        if(devices[i]->isReady()) queue[queue_len++] = i;
+    }
+    core_util_atomic_store_u32(&queue_pos, 0);
+    if(queue_len) {
+        MAX31856* first = devices[queue[0]];
+        first->spi.lock();          //thread context: the format is applied once for the whole queue, the transfer events cannot lock
+        first->applySpiFormat();
+        startQueuedTransfer();
+        first->spi.unlock();
+    }
+    return harvested;
+}
+
+
+//*****************************************************************************
+void MAX31856Bus::startQueuedTransfer()
+{
+    uint32_t pos = queue_pos;
+    while(pos < queue_len && !devices[queue[pos]]->startAsync(callback(this, &MAX31856Bus::transferDone)))
+        pos++;              //result no longer ready, completeAsync() will report nothing for this channel
+    core_util_atomic_store_u32(&queue_pos, pos);
+}
+
+
+//*****************************************************************************
+void MAX31856Bus::transferDone()
+{
+    core_util_atomic_store_u32(&queue_pos, queue_pos + 1);
+    startQueuedTransfer();   //chip select of the previous device was released by its own transfer event
+}
+#endif
+
+
+//*****************************************************************************
+void MAX31856Bus::attachResultCallback(Callback<void(uint8_t, float)> _callback)
+{
+    result_callback = _callback;
+}
+
+
+//*****************************************************************************
+float MAX31856Bus::getResult(uint8_t channel) const
+{
+    return (channel < device_count) ? results[channel] : NAN;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856Bus::getSampleCount(uint8_t channel) const
+{
+    return (channel < device_count) ? sample_count[channel] : 0;
+}
+
+
+//*****************************************************************************
+uint8_t MAX31856Bus::getDeviceCount() const
+{
+    return device_count;
+}
+
+
+//*****************************************************************************
+void MAX31856Bus::setClock(uint32_t (*_clock_us)(void))
+{
+    clock_us = _clock_us;
+}
+
+
+//*****************************************************************************
+MAX31856Bus::~MAX31856Bus(void) 
+{
+    //empty block
+}
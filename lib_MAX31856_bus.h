@@ -0,0 +1,234 @@
+/******************************************************************//**
+* @file lib_MAX31856_bus.h
+*
+* @version 1.0
+*
+* @brief Header file for MAX31856Bus class
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_BUS_h
+#define MAX31856_BUS_h
+#include "lib_MAX31856.h"
+
+//*****************************************************************************   
+///Parameters that are used throughout the scheduler
+//*****************************************************************************   
+#define MAX31856_BUS_MAX_DEVICES           32
+
+
+/**
+ * @brief Scheduler for several MAX31856 sharing one SPI bus\n
+ * Conversions are started on every device with a configurable stagger between channels, each result is harvested
+ * as soon as it is ready and the conversion of that channel is restarted right away, so conversions of all channels
+ * overlap and the aggregate sample rate approaches the number of channels divided by the conversion time.
+ *
+ * @code
+ * #include "mbed.h"
+ * #include "lib_MAX31856.h"
+ * #include "lib_MAX31856_bus.h"
+ *
+ * SPI spi(SPIO MOSI,SPIO MISO,SPIO SCK);
+ * MAX31856 Thermocouple1(spi, CHIPSELECT1);
+ * MAX31856 Thermocouple2(spi, CHIPSELECT2);
+ * MAX31856Bus bus(2000);
+ *
+ * int main(void)
+ * {
+ *      bus.addDevice(&Thermocouple1);
+ *      bus.addDevice(&Thermocouple2);
+ *      bus.start();
+ *      while(true)
+ *      {
+ *          if(bus.poll())
+ *              printf("TC1 = %f   TC2 = %f\n\r", bus.getResult(0), bus.getResult(1));
+ *      }
+ * }
+ * @endcode
+ */
+class MAX31856Bus
+{
+
+public:
+//*****************************************************************************    
+//Constructor and Destructor for the class
+//***************************************************************************** 
+    /**
+    * @brief Constructor to create an empty scheduler
+    * @param _stagger_us - Delay in microseconds between the start of the conversions of two consecutive channels
+    */
+    MAX31856Bus(uint32_t _stagger_us=0);
+    
+    
+    /** @brief Destructor */
+    ~MAX31856Bus(void);
+    
+    
+//*****************************************************************************    
+//Scheduling Functions
+//***************************************************************************** 
+    /** 
+    * @brief  Adds a device to the scheduler, its channel number is its rank of addition starting at 0
+    * @param device - Pointer to an initialized MAX31856 object
+    * @return       \li 1 on success   
+    *               \li 0 if MAX31856_BUS_MAX_DEVICES devices are already scheduled or the scheduler is running
+    */
+    bool addDevice(MAX31856* device);
+    
+    
+    /** @brief  Starts the scheduling, conversions are started by the following calls to poll() according to the stagger */
+    void start();
+    
+    
+    /** @brief  Stops the scheduling, conversions in progress are left to complete and are not harvested */
+    void stop();
+    
+    
+    /** 
+    * @brief  Starts the conversions that are due and harvests every conversion that is ready, never waits for a conversion\n
+    *         Call it from thread context as often as possible
+    * @return number of new results harvested during this call
+    */
+    uint8_t poll();
+    
+    
+#if DEVICE_SPI_ASYNCH
+    /** 
+    * @brief  Same as poll() with the result frames of all ready channels queued as asynchronous transfers (MAX31856::pollAsync()),
+    *         clocked back to back from the transfer events while the calling thread is free\n
+    *         Results are decoded by the first call after the whole queue completed, the calls in between return at once.
+    *         Do not use poll() or other functions of the devices on the same SPI bus while the scheduler runs this way.
+    *         The SPI bus is locked and its format applied once per call from thread context, the transfer events only start
+    *         frames: all devices must share the SPI object and clock (MAX31856::setSpiFrequency()), a device with other settings
+    *         is only read when it is the first ready channel
+    * @return number of new results harvested during this call
+    */
+    uint8_t pollAsync();
+#endif
+    
+    
+    /** 
+    * @brief  Registers a function called from poll() for each new result, except those suppressed by the deadband of the device
+    *         (MAX31856::setDeadband())
+    * @param _callback - Function taking the channel number and the thermocouple temperature in °C
+    */
+    void attachResultCallback(Callback<void(uint8_t, float)> _callback);
+    
+    
+    /** 
+    * @param channel - Channel number of the device
+    * @return last valid thermocouple temperature of the channel in °C, NAN if none was harvested yet
+    */
+    float getResult(uint8_t channel) const;
+    
+    
+    /** 
+    * @param channel - Channel number of the device
+    * @return number of valid results harvested for the channel since start()
+    */
+    uint32_t getSampleCount(uint8_t channel) const;
+    
+    
+    /** @return number of devices added to the scheduler */
+    uint8_t getDeviceCount() const;
+    
+    
+    /**
+    * @brief Replaces the monotonic microsecond clock used for the stagger (us_ticker_read() by default)
+    * @param _clock_us - Function returning a free running time in microseconds, wrapping around at 2^32
+    */
+    void setClock(uint32_t (*_clock_us)(void));
+    
+
+private:
+#if DEVICE_SPI_ASYNCH
+//*****************************************************************************    
+//Private Functions
+//*****************************************************************************
+    /** @brief  Starts the transfer of the next queued channel from queue_pos, skips the channels whose transfer cannot start.
+    *          Never locks the SPI bus nor meters the call, it runs in interrupt context from transferDone() */
+    void startQueuedTransfer();
+    
+    /** @brief  Called from interrupt context at the end of each queued transfer */
+    void transferDone();
+    
+    
+#endif
+//*****************************************************************************    
+//Private Members
+//*****************************************************************************
+    /// Scheduled devices indexed by channel
+    MAX31856* devices[MAX31856_BUS_MAX_DEVICES];
+    
+    /// Last valid result of each channel
+    float results[MAX31856_BUS_MAX_DEVICES];
+    
+    /// Number of valid results harvested for each channel
+    uint32_t sample_count[MAX31856_BUS_MAX_DEVICES];
+    
+    /// 1=a conversion was started on the channel since start()
+    bool started[MAX31856_BUS_MAX_DEVICES];
+    
+    /// Number of scheduled devices
+    uint8_t device_count = 0;
+    
+    /// Delay in microseconds between the start of two consecutive channels
+    uint32_t stagger_us;
+    
+    /// Time in microseconds at which start() was called
+    uint32_t start_time = 0;
+    
+    /// 1=scheduler started
+    bool running = false;
+    
+#if DEVICE_SPI_ASYNCH
+    /// Channels whose result frame is queued by pollAsync(), in transfer order
+    uint8_t queue[MAX31856_BUS_MAX_DEVICES];
+    
+    /// Number of queued channels
+    uint8_t queue_len = 0;
+    
+    /// Rank in the queue of the transfer in progress, equal to queue_len once the queue completed
+    volatile uint32_t queue_pos = 0;
+#endif
+    
+    /// Function called from poll() for each new result
+    Callback<void(uint8_t, float)> result_callback;
+    
+    /// Monotonic microsecond clock used for the stagger
+    uint32_t (*clock_us)(void) = us_ticker_read;
+};
+
+#endif  /* MAX31856_BUS_h */
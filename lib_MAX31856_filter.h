@@ -0,0 +1,291 @@
+/******************************************************************//**
+* @file lib_MAX31856_filter.h
+*
+* @version 1.0
+*
+* @brief Header file for the fixed point filters of the raw MAX31856 readings
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_FILTER_h
+#define MAX31856_FILTER_h
+#include "lib_MAX31856.h"
+
+//*****************************************************************************   
+///Parameters that are used throughout the filters
+//*****************************************************************************   
+#define MAX31856_FILTER_FRAC_BITS          8       //fractional bits kept below the 1/128 °C LSB by the EMA and Kalman states
+#define MAX31856_FILTER_ONE                (1 << MAX31856_FILTER_FRAC_BITS)
+#define MAX31856_KALMAN_GAIN_BITS          16      //fractional bits of the Kalman gain
+#define MAX31856_KALMAN_MAX_VARIANCE       ((1UL << (30 - MAX31856_FILTER_FRAC_BITS)) - 1)  //in LSB², keeps p + q + r below 2^32 once scaled
+
+
+/** 
+ * @brief Median of the last N readings, rejects spikes shorter than (N+1)/2 readings with a delay of (N-1)/2 readings\n
+ * A sorted copy of the window is updated by insertion, N compares and moves per reading
+ * @tparam N - Odd window length from 3 to 15
+ */
+template<uint8_t N>
+class MAX31856Median
+{
+    static_assert(N >= 3 && N <= 15 && (N & 1), "MAX31856Median window must be odd, from 3 to 15");
+
+public:
+    /** 
+    * @param raw - Thermocouple reading in 1/128 °C
+    * @return median of the last N readings, of the readings received so far until the window is full
+    */
+    int32_t update(int32_t raw)
+    {
+        if(raw == TC_RAW_INVALID) return TC_RAW_INVALID;
+        uint8_t i;
+        if(count == N) {    //drop the oldest reading from the sorted copy
+            int32_t oldest = window[pos];
+            for(i=0; sorted[i] != oldest; i++);
+            for(; i<N-1; i++) sorted[i] = sorted[i+1];
+            count--;
+        }
+        window[pos] = raw;
+        pos = (pos + 1 == N) ? 0 : pos + 1;
+        for(i=count; i>0 && sorted[i-1] > raw; i--) sorted[i] = sorted[i-1];
+        sorted[i] = raw;
+        count++;
+        return sorted[count/2];
+    }
+    
+    
+    /** @brief Empties the window */
+    void reset()
+    {
+        pos = 0;
+        count = 0;
+    }
+    
+
+private:
+    /// Readings in order of arrival, the oldest at pos once the window is full
+    int32_t window[N];
+    
+    /// Readings of the window sorted in increasing order
+    int32_t sorted[N];
+    
+    uint8_t pos = 0;
+    uint8_t count = 0;
+};
+
+
+/** 
+ * @brief Exponential moving average y += (x - y) / 2^Shift, equivalent to about 2^(Shift+1) - 1 averaged readings\n
+ * One subtraction, one shift and one addition per reading
+ * @tparam Shift - Smoothing from 1 to 8
+ */
+template<uint8_t Shift>
+class MAX31856EMA
+{
+    static_assert(Shift >= 1 && Shift <= 8, "MAX31856EMA shift must be from 1 to 8");
+
+public:
+    /** 
+    * @param raw - Thermocouple reading in 1/128 °C
+    * @return filtered reading in 1/128 °C, the first reading is returned as is
+    */
+    int32_t update(int32_t raw)
+    {
+        if(raw == TC_RAW_INVALID) return TC_RAW_INVALID;
+        int32_t x = raw * MAX31856_FILTER_ONE;
+        if(!primed) {
+            state = x;
+            primed = true;
+        }
+        else
+            state += (x - state + (1 << (Shift-1))) >> Shift;   //rounded, arithmetic shift of negative values
+        return (state + MAX31856_FILTER_ONE/2) >> MAX31856_FILTER_FRAC_BITS;
+    }
+    
+    
+    /** @brief Restarts from the next reading */
+    void reset()
+    {
+        primed = false;
+    }
+    
+
+private:
+    /// Filtered value in 1/(128 * MAX31856_FILTER_ONE) °C
+    int32_t state = 0;
+    
+    bool primed = false;
+};
+
+
+/** 
+ * @brief Scalar Kalman filter for a temperature following a random walk\n
+ * The gain adapts from 1 at the first reading to its steady state sqrt(Q/R) approximately, which smooths
+ * like an EMA but settles faster after reset(). One 64 bits division per reading
+ * @tparam Q - Default process noise variance per reading in LSB² (1 LSB = 1/128 °C), how much the temperature may move
+ * @tparam R - Default measurement noise variance in LSB², from 1 to MAX31856_KALMAN_MAX_VARIANCE
+ */
+template<uint32_t Q=1, uint32_t R=1024>
+class MAX31856Kalman
+{
+    static_assert(R >= 1 && R <= MAX31856_KALMAN_MAX_VARIANCE && Q <= MAX31856_KALMAN_MAX_VARIANCE, "MAX31856Kalman variances out of range");
+
+public:
+    /** 
+    * @brief  Changes the noise variances at run time, for example after changing the averaging of the MAX31856
+    * @param process - Process noise variance per reading in LSB², up to MAX31856_KALMAN_MAX_VARIANCE
+    * @param measurement - Measurement noise variance in LSB², from 1 to MAX31856_KALMAN_MAX_VARIANCE
+    * @return       \li 1 on success
+    *               \li 0 if a variance is out of range, the variances are not changed
+    */
+    bool setNoise(uint32_t process, uint32_t measurement)
+    {
+        if(process > MAX31856_KALMAN_MAX_VARIANCE || measurement < 1 || measurement > MAX31856_KALMAN_MAX_VARIANCE) return false;
+        q = process * MAX31856_FILTER_ONE;
+        r = measurement * MAX31856_FILTER_ONE;
+        if(p > r) p = r;    //the estimate is never less certain than a single reading
+        return true;
+    }
+    
+    
+    /** 
+    * @param raw - Thermocouple reading in 1/128 °C
+    * @return estimated temperature in 1/128 °C, the first reading is returned as is
+    */
+    int32_t update(int32_t raw)
+    {
+        if(raw == TC_RAW_INVALID) return TC_RAW_INVALID;
+        int32_t z = raw * MAX31856_FILTER_ONE;
+        if(!primed) {
+            x = z;
+            p = r;
+            primed = true;
+            return raw;
+        }
+        p += q;     //p <= r before, the sum stays below 2^32 with the variances in range
+        uint32_t k = (uint32_t)(((uint64_t)p << MAX31856_KALMAN_GAIN_BITS) / ((uint64_t)p + r));
+        x += (int32_t)(((int64_t)(z - x) * k) >> MAX31856_KALMAN_GAIN_BITS);
+        p = (uint32_t)(((uint64_t)p * ((1UL << MAX31856_KALMAN_GAIN_BITS) - k)) >> MAX31856_KALMAN_GAIN_BITS);
+        return (x + MAX31856_FILTER_ONE/2) >> MAX31856_FILTER_FRAC_BITS;
+    }
+    
+    
+    /** @brief Restarts from the next reading */
+    void reset()
+    {
+        primed = false;
+    }
+    
+
+private:
+    /// Estimate in 1/(128 * MAX31856_FILTER_ONE) °C
+    int32_t x = 0;
+    
+    /// Variances of the estimate, the process and the measurement in LSB² * MAX31856_FILTER_ONE
+    uint32_t p = 0;
+    uint32_t q = Q * MAX31856_FILTER_ONE;
+    uint32_t r = R * MAX31856_FILTER_ONE;
+    
+    bool primed = false;
+};
+
+
+/**
+ * @brief Chain of filter stages running in fixed point on the raw thermocouple readings (signed 19 bits in 1/128 °C)
+ * of readTCRaw() or readSample()\n
+ * The stages are applied in the order of the template arguments, resolved at compile time without virtual calls.
+ * Every stage has int32_t update(int32_t raw) returning the filtered raw value and reset(), uses static storage only
+ * and passes TC_RAW_INVALID through without changing its state.
+ * Feed each conversion result once: readSample() gives one call per result, readTCRaw() returns the
+ * last result again until the next conversion completes.
+ *
+ * @code
+ * MAX31856FilterPipeline<MAX31856Median<5>, MAX31856Kalman<1, 1024> > filter;
+ *
+ * MAX31856::Sample sample;
+ * if(Thermocouple1.readSample(sample))
+ *      printf("%f\n", MAX31856::tcRawToCelsius(filter.update(sample.tc_raw)));
+ * @endcode
+ *
+ * @tparam Stages - Classes with int32_t update(int32_t) and reset(), MAX31856Median, MAX31856EMA, MAX31856Kalman or custom ones
+ */
+template<typename... Stages>
+class MAX31856FilterPipeline;
+
+/** @brief Empty end of a MAX31856FilterPipeline */
+template<>
+class MAX31856FilterPipeline<>
+{
+public:
+    int32_t update(int32_t raw) { return raw; }
+    void reset() {}
+};
+
+template<typename First, typename... Rest>
+class MAX31856FilterPipeline<First, Rest...>
+{
+public:
+    /** 
+    * @param raw - Thermocouple reading in 1/128 °C
+    * @return reading in 1/128 °C filtered by all the stages
+    */
+    int32_t update(int32_t raw)
+    {
+        return rest.update(stage.update(raw));
+    }
+    
+    
+    /** @brief Resets all the stages */
+    void reset()
+    {
+        stage.reset();
+        rest.reset();
+    }
+    
+    
+    /** @return first stage, to change its settings */
+    First& first() { return stage; }
+    
+    
+    /** @return pipeline of the following stages */
+    MAX31856FilterPipeline<Rest...>& next() { return rest; }
+    
+
+private:
+    First stage;
+    MAX31856FilterPipeline<Rest...> rest;
+};
+
+#endif  /* MAX31856_FILTER_h */
@@ -0,0 +1,58 @@
+/******************************************************************//**
+* @file lib_MAX31856_hal.h
+*
+* @version 1.0
+*
+* @brief Hardware abstraction used by the MAX31856 library
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_HAL_h
+#define MAX31856_HAL_h
+
+//*****************************************************************************
+//The library only uses the following part of the mbed API:
+//SPI, DigitalOut, InterruptIn, Timeout, Callback, wait_us(), us_ticker_read()
+//and the core_util_atomic functions.
+//On target it comes from mbed, when MAX31856_HOST is defined it comes from
+//lib_MAX31856_host.h which runs the library on a PC against simulated devices.
+//*****************************************************************************
+#if defined(MAX31856_HOST)
+#include "lib_MAX31856_host.h"
+#else
+#include "mbed.h"
+#endif
+
+#endif  /* MAX31856_HAL_h */
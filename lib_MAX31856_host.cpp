@@ -0,0 +1,523 @@
+/******************************************************************//**
+* @file lib_MAX31856_host.cpp
+*
+* @version 1.0
+*
+* @brief Host (PC) implementation of the mbed API subset used by the library and MAX31856 simulator
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#if defined(MAX31856_HOST)
+#include "lib_MAX31856_host.h"
+#include "lib_MAX31856.h"
+#include <vector>
+#include <algorithm>
+
+//*****************************************************************************
+//Simulated time, pins and registries
+//*****************************************************************************
+static std::atomic<uint64_t> host_now_ns(0);   //read by the threads of a test without holding the SPI lock
+static int host_pins[MAX31856_HOST_MAX_PINS];
+static bool host_pins_init = false;
+static std::vector<MAX31856Sim*> host_sims;
+static std::vector<Timeout*> host_timeouts;
+static std::vector<InterruptIn*> host_interrupts;
+
+static int& pinLevel(PinName pin)
+{
+    static int dummy;
+    if(!host_pins_init) {
+        for(int i=0; i<MAX31856_HOST_MAX_PINS; i++) host_pins[i] = 1;
+        host_pins_init = true;
+    }
+    if(pin < 0 || pin >= MAX31856_HOST_MAX_PINS) return dummy = 1;
+    return host_pins[pin];
+}
+
+//*****************************************************************************
+uint64_t MAX31856Host::now()
+{
+    return host_now_ns / 1000;
+}
+
+//*****************************************************************************
+void MAX31856Host::advanceNs(uint64_t ns)
+{
+    uint64_t target = host_now_ns + ns;
+    while(true) {
+        //find the earliest event due before the target time
+        uint64_t next = target + 1;
+        MAX31856Sim* sim_due = NULL;
+        Timeout* timeout_due = NULL;
+        for(MAX31856Sim* sim : host_sims)
+            if(sim->nextEvent() && sim->nextEvent()*1000 < next) { next = sim->nextEvent()*1000; sim_due = sim; }
+        for(Timeout* timeout : host_timeouts)
+            if(timeout->armed && timeout->deadline*1000 < next) { next = timeout->deadline*1000; timeout_due = timeout; sim_due = NULL; }
+        if(next > target) break;
+        if(next > host_now_ns) host_now_ns = next;
+        if(sim_due) sim_due->complete();
+        else {
+            timeout_due->armed = false;
+            if(timeout_due->handler) timeout_due->handler();
+        }
+    }
+    host_now_ns = target;
+}
+
+//*****************************************************************************
+void MAX31856Host::advance(uint32_t us)
+{
+    advanceNs((uint64_t)us * 1000);
+}
+
+//*****************************************************************************
+void MAX31856Host::setPin(PinName pin, int level)
+{
+    int& current = pinLevel(pin);
+    level = level ? 1 : 0;
+    if(current == level) return;
+    current = level;
+    for(InterruptIn* irq : host_interrupts) {
+        if(irq->pin != pin) continue;
+        if(level == 0 && irq->fall_callback) irq->fall_callback();
+        if(level == 1 && irq->rise_callback) irq->rise_callback();
+    }
+}
+
+//*****************************************************************************
+int MAX31856Host::getPin(PinName pin)
+{
+    return pinLevel(pin);
+}
+
+//*****************************************************************************
+void MAX31856Host::reset()
+{
+    host_now_ns = 0;
+    host_pins_init = false;
+    for(Timeout* timeout : host_timeouts) timeout->armed = false;
+}
+
+//*****************************************************************************
+void MAX31856Host::registerSim(MAX31856Sim* sim) { host_sims.push_back(sim); }
+void MAX31856Host::unregisterSim(MAX31856Sim* sim) { host_sims.erase(std::remove(host_sims.begin(), host_sims.end(), sim), host_sims.end()); }
+void MAX31856Host::registerTimeout(Timeout* timeout) { host_timeouts.push_back(timeout); }
+void MAX31856Host::unregisterTimeout(Timeout* timeout) { host_timeouts.erase(std::remove(host_timeouts.begin(), host_timeouts.end(), timeout), host_timeouts.end()); }
+void MAX31856Host::registerInterrupt(InterruptIn* irq) { host_interrupts.push_back(irq); }
+void MAX31856Host::unregisterInterrupt(InterruptIn* irq) { host_interrupts.erase(std::remove(host_interrupts.begin(), host_interrupts.end(), irq), host_interrupts.end()); }
+
+//*****************************************************************************
+MAX31856Sim* MAX31856Host::selected()
+{
+    for(MAX31856Sim* sim : host_sims)
+        if(sim->isSelected()) return sim;
+    return NULL;
+}
+
+//*****************************************************************************
+int MAX31856Host::selectedCount()
+{
+    int count = 0;
+    for(MAX31856Sim* sim : host_sims)
+        if(sim->isSelected()) count++;
+    return count;
+}
+
+
+//*****************************************************************************
+//mbed API subset
+//*****************************************************************************
+void wait_us(int us)
+{
+    if(us > 0) MAX31856Host::advance(us);
+}
+
+//*****************************************************************************
+uint32_t us_ticker_read(void)
+{
+    return (uint32_t)MAX31856Host::now();
+}
+
+//*****************************************************************************
+SPI::SPI(PinName mosi, PinName miso, PinName sclk)
+{
+    transfer_timeout = new Timeout();
+}
+
+//*****************************************************************************
+SPI::~SPI()
+{
+    delete transfer_timeout;
+}
+
+//*****************************************************************************
+int SPI::write(int value)
+{
+    uint64_t ns = (uint64_t)bits * 1000000000ULL / hz;
+    bus_time_ns += ns;
+    byte_count++;
+    MAX31856Sim* sim = select(1);
+    int miso = sim ? sim->transfer(value) : 0xFF;   //MISO is pulled up when nothing drives it
+    MAX31856Host::advanceNs(ns);
+    return miso;
+}
+
+//*****************************************************************************
+int SPI::transfer(const uint8_t* tx_buffer, int tx_length, uint8_t* rx_buffer, int rx_length, const event_callback_t& cb, int event)
+{
+    if(transfer_busy) return -1;
+    int len = (tx_length > rx_length) ? tx_length : rx_length;
+    uint64_t ns = (uint64_t)bits * len * 1000000000ULL / hz;
+    MAX31856Sim* sim = select(len);
+    for(int i=0; i<len; i++) {
+        int miso = sim ? sim->transfer((i < tx_length) ? tx_buffer[i] : 0xFF) : 0xFF;   //mbed clocks 0xFF past the end of tx_buffer
+        if(i < rx_length) rx_buffer[i] = miso;
+    }
+    bus_time_ns += ns;
+    byte_count += len;
+    transfer_busy = true;
+    transfer_callback = cb;
+    transfer_event = event;
+    transfer_timeout->attach_us(callback(this, &SPI::transferDone), (uint32_t)((ns + 999) / 1000));
+    return 0;
+}
+
+//*****************************************************************************
+MAX31856Sim* SPI::select(int len)
+{
+    MAX31856Sim* sim = MAX31856Host::selected();
+    if(MAX31856Host::selectedCount() > 1 || (sim && !(mode & 1))) error_count += len;   //the MAX31856 samples on the second clock edge, modes 1 and 3
+    return sim;
+}
+
+//*****************************************************************************
+void SPI::transferDone()
+{
+    transfer_busy = false;
+    if(transfer_callback && (transfer_event & SPI_EVENT_COMPLETE)) transfer_callback(SPI_EVENT_COMPLETE);
+}
+
+//*****************************************************************************
+void SPI::format(int _bits, int _mode)
+{
+    bits = _bits;
+    mode = _mode;
+    format_count++;
+}
+
+//*****************************************************************************
+void SPI::frequency(int _hz)
+{
+    hz = _hz;
+}
+
+//*****************************************************************************
+void SPI::lock() { mutex.lock(); }
+void SPI::unlock() { mutex.unlock(); }
+
+//*****************************************************************************
+uint32_t SPI::getFrameCount() const
+{
+    uint32_t frames = 0;
+    for(MAX31856Sim* sim : host_sims) frames += sim->getFrameCount();
+    return frames - frame_base;
+}
+
+//*****************************************************************************
+void SPI::resetCounters()
+{
+    byte_count = 0;
+    error_count = 0;
+    format_count = 0;
+    bus_time_ns = 0;
+    frame_base = 0;
+    frame_base = getFrameCount();
+}
+
+//*****************************************************************************
+DigitalOut::DigitalOut(PinName _pin, int value) : pin(_pin)
+{
+    write(value);
+}
+
+//*****************************************************************************
+void DigitalOut::write(int value)
+{
+    MAX31856Host::setPin(pin, value);
+    for(MAX31856Sim* sim : host_sims)
+        if(sim->getChipSelect() == pin) sim->select(value == 0);
+}
+
+//*****************************************************************************
+int DigitalOut::read()
+{
+    return MAX31856Host::getPin(pin);
+}
+
+//*****************************************************************************
+InterruptIn::InterruptIn(PinName _pin) : pin(_pin)
+{
+    MAX31856Host::registerInterrupt(this);
+}
+
+//*****************************************************************************
+InterruptIn::~InterruptIn()
+{
+    MAX31856Host::unregisterInterrupt(this);
+}
+
+//*****************************************************************************
+void InterruptIn::fall(Callback<void()> func) { fall_callback = func; }
+void InterruptIn::rise(Callback<void()> func) { rise_callback = func; }
+int InterruptIn::read() { return MAX31856Host::getPin(pin); }
+
+//*****************************************************************************
+Timeout::Timeout()
+{
+    MAX31856Host::registerTimeout(this);
+}
+
+//*****************************************************************************
+Timeout::~Timeout()
+{
+    MAX31856Host::unregisterTimeout(this);
+}
+
+//*****************************************************************************
+void Timeout::attach_us(Callback<void()> func, uint32_t us)
+{
+    handler = func;
+    deadline = MAX31856Host::now() + us;
+    armed = true;
+}
+
+//*****************************************************************************
+void Timeout::detach()
+{
+    armed = false;
+}
+
+
+//*****************************************************************************
+//MAX31856 model
+//*****************************************************************************
+static const uint8_t factory_defaults[16] = {0x00, 0x03, 0xFF, 0x7F, 0xC0, 0x7F, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+//Operating range of each thermocouple type in °C, used for the TC range fault bit
+static const int16_t tc_range[8][2] = {{250, 1820}, {-200, 1000}, {-210, 1200}, {-200, 1372}, {-200, 1300}, {-50, 1768}, {-50, 1768}, {-200, 400}};
+
+//*****************************************************************************
+MAX31856Sim::MAX31856Sim(PinName _ncs, PinName _drdy, PinName _fault) : ncs(_ncs), drdy(_drdy), fault(_fault)
+{
+    memcpy(reg, factory_defaults, sizeof(reg));
+    MAX31856Host::registerSim(this);
+    updatePins();
+}
+
+//*****************************************************************************
+MAX31856Sim::~MAX31856Sim()
+{
+    MAX31856Host::unregisterSim(this);
+}
+
+//*****************************************************************************
+void MAX31856Sim::setTemperature(float _tc, float _cj)
+{
+    tc = _tc;
+    cj = _cj;
+}
+
+//*****************************************************************************
+void MAX31856Sim::setVoltage(float _volts)
+{
+    volts = _volts;
+}
+
+//*****************************************************************************
+void MAX31856Sim::setOpenCircuit(bool _open)
+{
+    open_circuit = _open;
+}
+
+//*****************************************************************************
+void MAX31856Sim::setOverUnderVoltage(bool _ovuv)
+{
+    ovuv = _ovuv;
+    updateFaults(false);
+}
+
+//*****************************************************************************
+uint32_t MAX31856Sim::conversionTime() const
+{
+    uint32_t samples = 1 << ((reg[ADDRESS_CR1_READ] >> 4) & 0x07);
+    if(samples > 16) samples = 16;
+    bool fifty = reg[ADDRESS_CR0_READ] & CR0_FILTER_OUT_50Hz;
+    bool continuous = (reg[ADDRESS_CR0_READ] & CR0_CONV_MODE_NORMALLY_ON) && !first_conversion;
+    uint32_t us;    //conversion times of the data sheet, table 3
+    if(!continuous) us = fifty ? 98000 + (samples-1)*40000 : 82000 + (samples-1)*33330;
+    else            us = fifty ? 98000 + (samples-1)*20000 : 82000 + (samples-1)*16670;
+    if(reg[ADDRESS_CR0_READ] & CR0_COLD_JUNC_DISABLE) us -= 25000;
+    if(reg[ADDRESS_CR0_READ] & 0x30) us += ((reg[ADDRESS_CR0_READ] & 0x30) == CR0_OC_DETECT_ENABLED_TC_MORE_2ms) ? 40000 : 13000; //open circuit detection
+    return us;
+}
+
+//*****************************************************************************
+void MAX31856Sim::select(bool low)
+{
+    if(low && !selected) {
+        frame_count++;
+        address = -1;
+    }
+    selected = low;
+}
+
+//*****************************************************************************
+uint8_t MAX31856Sim::transfer(uint8_t mosi)
+{
+    if(address < 0) {           //first byte of a frame is the address
+        address = mosi;
+        return 0;
+    }
+    uint8_t a = address & 0x0F;
+    uint8_t miso = 0;
+    if(address & 0x80)
+        writeRegister(a, mosi);
+    else {
+        miso = reg[a];
+        if(a >= ADDRESS_LTCBH_READ && a <= ADDRESS_LTCBL_READ && drdy != NC) MAX31856Host::setPin(drdy, 1); //DRDY returns high when the result is read
+    }
+    address = (address & 0x80) | ((a + 1) & 0x0F);
+    return miso;
+}
+
+//*****************************************************************************
+void MAX31856Sim::writeRegister(uint8_t a, uint8_t val)
+{
+    if(a > ADDRESS_CJTL_READ) return;   //LTCB and SR are read only
+    uint8_t previous = reg[ADDRESS_CR0_READ];
+    reg[a] = val;
+    if(a != ADDRESS_CR0_READ) {
+        updatePins();
+        return;
+    }
+    if(val & CR0_FAULTCLR_RETURN_FAULTS_TO_ZERO) {  //clears the latched faults in interrupt mode and self clears
+        reg[ADDRESS_SR_READ] = live_faults & 0xFC;  //range and threshold bits are recomputed, OPEN and OVUV wait for the next conversion
+        reg[ADDRESS_CR0_READ] &= ~CR0_FAULTCLR_RETURN_FAULTS_TO_ZERO;
+    }
+    if((val & CR0_1_SHOT_MODE_ONE_CONVERSION) && !(val & CR0_CONV_MODE_NORMALLY_ON)) {
+        first_conversion = true;
+        startConversion();
+    }
+    else if((val & CR0_CONV_MODE_NORMALLY_ON) && !(previous & CR0_CONV_MODE_NORMALLY_ON)) {
+        first_conversion = true;
+        startConversion();
+    }
+    updatePins();   //a conversion in progress completes, leaving normally on mode stops the following ones
+}
+
+//*****************************************************************************
+void MAX31856Sim::startConversion()
+{
+    converting = true;
+    conversion_end = MAX31856Host::now() + conversionTime();
+}
+
+//*****************************************************************************
+void MAX31856Sim::complete()
+{
+    //update the result registers
+    uint8_t type = reg[ADDRESS_CR1_READ] & 0x0F;
+    int32_t code;
+    if(type & CR1_TC_TYPE_VOLT_MODE_GAIN_8)     //voltage mode, code = V x gain x 1.6 x 2^17
+        code = (int32_t)lrintf(volts * ((type == CR1_TC_TYPE_VOLT_MODE_GAIN_32) ? 32 : 8) * 1.6f * 131072.0f);
+    else
+        code = (int32_t)lrintf(tc * 128.0f);
+    if(code > 0x3FFFF) code = 0x3FFFF;
+    if(code < -0x40000) code = -0x40000;
+    uint32_t ltcb = ((uint32_t)code << 5) & 0xFFFFFF;
+    reg[ADDRESS_LTCBH_READ] = ltcb >> 16;
+    reg[ADDRESS_LTCBM_READ] = ltcb >> 8;
+    reg[ADDRESS_LTCBL_READ] = ltcb;
+    if(!(reg[ADDRESS_CR0_READ] & CR0_COLD_JUNC_DISABLE)) {
+        int16_t cj_code = (int16_t)lrintf(cj * 64.0f) << 2;  //14 bits, 0.015625 °C
+        reg[ADDRESS_CJTH_READ] = (uint16_t)cj_code >> 8;
+        reg[ADDRESS_CJTL_READ] = cj_code & 0xFF;
+    }
+    conversion_count++;
+    first_conversion = false;
+    updateFaults(true);
+    
+    //next conversion
+    reg[ADDRESS_CR0_READ] &= ~CR0_1_SHOT_MODE_ONE_CONVERSION;
+    if(reg[ADDRESS_CR0_READ] & CR0_CONV_MODE_NORMALLY_ON) startConversion();
+    else converting = false;
+    if(drdy != NC) {
+        MAX31856Host::setPin(drdy, 1);
+        MAX31856Host::setPin(drdy, 0);  //DRDY goes low once the new result is available
+    }
+    updatePins();
+}
+
+//*****************************************************************************
+void MAX31856Sim::updateFaults(bool from_conversion)
+{
+    uint8_t sr = 0;
+    uint8_t type = reg[ADDRESS_CR1_READ] & 0x0F;
+    int32_t tc_code = ((int32_t)((reg[ADDRESS_LTCBH_READ] << 24) | (reg[ADDRESS_LTCBM_READ] << 16) | (reg[ADDRESS_LTCBL_READ] << 8))) >> 13;
+    int16_t cj_code = (int16_t)((reg[ADDRESS_CJTH_READ] << 8) | reg[ADDRESS_CJTL_READ]);
+    int16_t lthft = (int16_t)((reg[ADDRESS_LTHFTH_READ] << 8) | reg[ADDRESS_LTHFTL_READ]);  //1/16 °C
+    int16_t ltlft = (int16_t)((reg[ADDRESS_LTLFTH_READ] << 8) | reg[ADDRESS_LTLFTL_READ]);
+    if(cj_code/256 < -55 || cj_code/256 > 125) sr |= 0x80;
+    if(type < 8 && (tc_code/128 < tc_range[type][0] || tc_code/128 > tc_range[type][1])) sr |= 0x40;
+    if(cj_code/256 > (int8_t)reg[ADDRESS_CJHF_READ]) sr |= 0x20;
+    if(cj_code/256 < (int8_t)reg[ADDRESS_CJLF_READ]) sr |= 0x10;
+    if(tc_code/8 > lthft) sr |= 0x08;
+    if(tc_code/8 < ltlft) sr |= 0x04;
+    if(ovuv) sr |= 0x02;
+    if(from_conversion) {
+        if(open_circuit && (reg[ADDRESS_CR0_READ] & 0x30)) sr |= 0x01;
+    }
+    else sr |= live_faults & 0x01;
+    live_faults = sr;
+    if(reg[ADDRESS_CR0_READ] & CR0_FAULT_MODE_INTERUPT) reg[ADDRESS_SR_READ] |= sr;   //latched until FAULTCLR
+    else reg[ADDRESS_SR_READ] = sr;
+}
+
+//*****************************************************************************
+void MAX31856Sim::updatePins()
+{
+    if(fault != NC) MAX31856Host::setPin(fault, (reg[ADDRESS_SR_READ] & ~reg[ADDRESS_MASK_READ] & 0x3F) ? 0 : 1); //FAULT is active low, MASK bits set to 1 mask the fault
+}
+
+#endif  /* MAX31856_HOST */
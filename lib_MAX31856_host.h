@@ -0,0 +1,342 @@
+/******************************************************************//**
+* @file lib_MAX31856_host.h
+*
+* @version 1.0
+*
+* @brief Host (PC) implementation of the mbed API subset used by the library and MAX31856 simulator
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_HOST_h
+#define MAX31856_HOST_h
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <functional>
+#include <mutex>
+#include <atomic>
+
+/**
+ * @brief Host build of the library\n
+ * Compile the library sources together with lib_MAX31856_host.cpp and -DMAX31856_HOST to run it on a PC.
+ * Time is simulated: it only moves forward with wait_us(), MAX31856Host::advance() and the SPI bytes clocked,
+ * so tests and benchmarks are deterministic and the bus time of every API call can be measured.
+ *
+ * @code
+ * SPI spi(0, 1, 2);
+ * MAX31856Sim sim(10, 11);            //chip select on pin 10, DRDY on pin 11
+ * sim.setTemperature(250.0f, 25.0f);
+ * MAX31856 Thermocouple1(spi, 10);
+ * MAX31856Host::advance(100000);      //let the first conversion complete
+ * printf("%f %u bytes\n", Thermocouple1.readTC(), spi.getByteCount());
+ * @endcode
+ */
+
+//*****************************************************************************
+//mbed API subset
+//*****************************************************************************
+typedef int PinName;
+#define NC                                 ((PinName)-1)
+#define MAX31856_HOST_MAX_PINS             256
+
+
+/** @brief Host version of mbed::Callback */
+template<typename F> class Callback;
+template<typename R, typename... A>
+class Callback<R(A...)>
+{
+public:
+    Callback() {}
+    Callback(R (*func)(A...)) : f(func) {}
+    template<typename T> Callback(T* obj, R (T::*method)(A...)) : f([obj, method](A... args) { return (obj->*method)(args...); }) {}
+    template<typename F> Callback(F func) : f(func) {}
+    R operator()(A... args) const { return f(args...); }
+    explicit operator bool() const { return (bool)f; }
+private:
+    std::function<R(A...)> f;
+};
+
+/** @brief Host version of mbed::callback() for member functions */
+template<typename T, typename R, typename... A>
+Callback<R(A...)> callback(T* obj, R (T::*method)(A...))
+{
+    return Callback<R(A...)>(obj, method);
+}
+
+
+#define DEVICE_SPI_ASYNCH                  1
+#define SPI_EVENT_COMPLETE                 (1 << 3)
+typedef Callback<void(int)> event_callback_t;
+class Timeout;
+class MAX31856Sim;
+
+/** @brief Host SPI master, bytes go to the simulated device whose chip select is low and take simulated bus time */
+class SPI
+{
+public:
+    SPI(PinName mosi, PinName miso, PinName sclk);
+    ~SPI();
+    int write(int value);
+    /** Asynchronous transfer like a DMA: the device sees the bytes at once, the simulated time does not advance
+    *   and cb is called from the timer once the bus time of the bytes has elapsed. Returns -1 while a transfer is in progress */
+    int transfer(const uint8_t* tx_buffer, int tx_length, uint8_t* rx_buffer, int rx_length, const event_callback_t& cb, int event=SPI_EVENT_COMPLETE);
+    void format(int bits, int mode=0);
+    void frequency(int hz=1000000);
+    /// Recursive mutex like the mbed SPI lock, so tests can share the bus between threads
+    void lock();
+    void unlock();
+    
+    /// Number of bytes clocked since construction or resetCounters()
+    uint32_t getByteCount() const { return byte_count; }
+    /// Number of chip select cycles seen by the simulated devices since construction or resetCounters()
+    uint32_t getFrameCount() const;
+    /// Simulated time spent clocking bytes in microseconds since construction or resetCounters()
+    uint32_t getBusTime() const { return (uint32_t)(bus_time_ns / 1000); }
+    /// Number of bytes clocked while several devices were selected or a device was selected in SPI mode 0 or 2 since construction or resetCounters()
+    uint32_t getErrorCount() const { return error_count; }
+    /// Number of calls of format() since construction or resetCounters()
+    uint32_t getFormatCount() const { return format_count; }
+    void resetCounters();
+    int getMode() const { return mode; }
+    int getFrequency() const { return hz; }
+    
+private:
+    int bits = 8;
+    int mode = 0;
+    int hz = 1000000;
+    uint32_t byte_count = 0;
+    uint32_t error_count = 0;
+    uint32_t format_count = 0;
+    uint32_t frame_base = 0;
+    uint64_t bus_time_ns = 0;
+    Timeout* transfer_timeout;
+    event_callback_t transfer_callback;
+    int transfer_event = 0;
+    bool transfer_busy = false;
+    std::recursive_mutex mutex;
+    void transferDone();
+    MAX31856Sim* select(int len);
+};
+
+
+/** @brief Host digital output, drives the chip select of the simulated device attached to the same pin */
+class DigitalOut
+{
+public:
+    DigitalOut(PinName pin, int value=1);
+    void write(int value);
+    int read();
+    DigitalOut& operator=(int value) { write(value); return *this; }
+    operator int() { return read(); }
+private:
+    PinName pin;
+};
+
+
+/** @brief Host interrupt input, edges are generated by the simulated devices or by MAX31856Host::setPin() */
+class InterruptIn
+{
+public:
+    InterruptIn(PinName pin);
+    ~InterruptIn();
+    void fall(Callback<void()> func);
+    void rise(Callback<void()> func);
+    int read();
+    operator int() { return read(); }
+private:
+    friend class MAX31856Host;
+    PinName pin;
+    Callback<void()> fall_callback;
+    Callback<void()> rise_callback;
+};
+
+
+/** @brief Host one shot timer running on simulated time */
+class Timeout
+{
+public:
+    Timeout();
+    ~Timeout();
+    void attach_us(Callback<void()> func, uint32_t us);
+    void detach();
+private:
+    friend class MAX31856Host;
+    Callback<void()> handler;
+    uint64_t deadline = 0;
+    bool armed = false;
+};
+
+
+/** @brief Waits by moving simulated time forward, pending events fire on the way */
+void wait_us(int us);
+
+/** @return simulated time in microseconds, wrapping around at 2^32 like the mbed us ticker */
+uint32_t us_ticker_read(void);
+
+inline uint32_t core_util_atomic_load_u32(const volatile uint32_t* ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+inline void core_util_atomic_store_u32(volatile uint32_t* ptr, uint32_t val) { __atomic_store_n(ptr, val, __ATOMIC_RELEASE); }
+inline uint32_t core_util_atomic_incr_u32(volatile uint32_t* ptr, uint32_t delta) { return __atomic_add_fetch(ptr, delta, __ATOMIC_SEQ_CST); }
+inline uint32_t core_util_atomic_fetch_or_u32(volatile uint32_t* ptr, uint32_t arg) { return __atomic_fetch_or(ptr, arg, __ATOMIC_SEQ_CST); }
+inline uint32_t core_util_atomic_exchange_u32(volatile uint32_t* ptr, uint32_t val) { return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST); }
+inline void* core_util_atomic_load_ptr(void* const volatile* ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+inline void core_util_atomic_store_ptr(void* volatile* ptr, void* val) { __atomic_store_n(ptr, val, __ATOMIC_RELEASE); }
+inline bool core_util_atomic_cas_ptr(void* volatile* ptr, void** expected, void* desired)
+{ return __atomic_compare_exchange_n(ptr, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+
+
+//*****************************************************************************
+//Simulation
+//*****************************************************************************
+/** @brief Simulated time and pins shared by the host classes */
+class MAX31856Host
+{
+public:
+    /** @return simulated time in microseconds since the start of the program */
+    static uint64_t now();
+    
+    /** @brief Moves simulated time forward, conversions and timers due on the way complete in order */
+    static void advance(uint32_t us);
+    
+    /** @brief Moves simulated time forward by a number of nanoseconds, used for the SPI bus time */
+    static void advanceNs(uint64_t ns);
+    
+    /** @brief Drives an input pin, generating the edges seen by an InterruptIn on the same pin */
+    static void setPin(PinName pin, int level);
+    
+    /** @return level of a pin, 1 if nothing drives it */
+    static int getPin(PinName pin);
+    
+    /** @brief Resets time, pins, timers and devices, used between tests */
+    static void reset();
+    
+private:
+    friend class SPI;
+    friend class DigitalOut;
+    friend class InterruptIn;
+    friend class Timeout;
+    friend class MAX31856Sim;
+    static void registerSim(MAX31856Sim* sim);
+    static void unregisterSim(MAX31856Sim* sim);
+    static void registerTimeout(Timeout* timeout);
+    static void unregisterTimeout(Timeout* timeout);
+    static void registerInterrupt(InterruptIn* irq);
+    static void unregisterInterrupt(InterruptIn* irq);
+    static MAX31856Sim* selected();
+    static int selectedCount();
+};
+
+
+/**
+ * @brief Register level model of a MAX31856\n
+ *      \li Register map with factory defaults, read/write addressing and address auto-increment
+ *      \li Conversion timing from CR0/CR1 (filter, averaging, cold junction, 1-shot and normally on modes)
+ *      \li Self clearing 1-shot and FAULTCLR bits
+ *      \li Fault status bits in comparator and interrupt mode, FAULT output with MASK, DRDY output
+ *      \li Voltage mode with gain 8 and 32
+ */
+class MAX31856Sim
+{
+public:
+    /**
+    * @param _ncs - Chip select pin, the same number is given to the MAX31856 object
+    * @param _drdy - DRDY output pin or NC
+    * @param _fault - FAULT output pin or NC
+    */
+    MAX31856Sim(PinName _ncs, PinName _drdy=NC, PinName _fault=NC);
+    ~MAX31856Sim();
+    
+    /** @brief Sets the temperatures measured by the next conversions */
+    void setTemperature(float _tc, float _cj);
+    
+    /** @brief Sets the thermocouple voltage measured by the next conversions in voltage mode */
+    void setVoltage(float _volts);
+    
+    /** @brief Simulates a broken thermocouple, flagged by the next conversion if open circuit detection is enabled */
+    void setOpenCircuit(bool _open);
+    
+    /** @brief Simulates an input over or under voltage */
+    void setOverUnderVoltage(bool _ovuv);
+    
+    /** @return contents of a register */
+    uint8_t getRegister(uint8_t address) const { return reg[address & 0x0F]; }
+    
+    /** @return number of conversions completed */
+    uint32_t getConversionCount() const { return conversion_count; }
+    
+    /** @return number of chip select cycles */
+    uint32_t getFrameCount() const { return frame_count; }
+    
+    /** @return duration in microseconds of a conversion with the current configuration */
+    uint32_t conversionTime() const;
+    
+    /** @brief Applies a chip select level */
+    void select(bool low);
+    
+    /** @brief Exchanges a byte while selected */
+    uint8_t transfer(uint8_t mosi);
+    
+    /** @return 1 while the chip select is low */
+    bool isSelected() const { return selected; }
+    
+    /** @return time of the next conversion end, 0 if no conversion is running */
+    uint64_t nextEvent() const { return converting ? conversion_end : 0; }
+    
+    /** @brief Completes the conversion due at the current simulated time */
+    void complete();
+    
+    PinName getChipSelect() const { return ncs; }
+
+private:
+    void writeRegister(uint8_t address, uint8_t val);
+    void startConversion();
+    void updateFaults(bool from_conversion);
+    void updatePins();
+    
+    PinName ncs, drdy, fault;
+    uint8_t reg[16];
+    bool selected = false;
+    int address = -1;
+    bool converting = false;
+    bool first_conversion = true;
+    uint64_t conversion_end = 0;
+    uint32_t conversion_count = 0;
+    uint32_t frame_count = 0;
+    float tc = 25.0f, cj = 25.0f, volts = 0.0f;
+    bool open_circuit = false, ovuv = false;
+    uint8_t live_faults = 0;
+};
+
+#endif  /* MAX31856_HOST_h */
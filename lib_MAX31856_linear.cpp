@@ -0,0 +1,371 @@
+/******************************************************************//**
+* @file lib_MAX31856_linear.cpp
+*
+* @version 1.0
+*
+* @brief Source file for MAX31856Linearization class
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "lib_MAX31856_linear.h"
+
+//*****************************************************************************
+//NIST ITS-90 thermocouple database, NIST Monograph 175
+//The bounds of the first and last inverse range are widened by 2 µV so the
+//rounded table limits of each type stay inside the description.
+//*****************************************************************************
+//Type B, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_B[] = {
+    {0.0f, 630.615f, 6, {0.0f, -0.0002465081835f, 5.904042117e-06f, -1.325793164e-09f, 1.56682919e-12f, -1.694452924e-15f, 6.299034709e-19f}},
+    {630.615f, 1820.0f, 8, {-3.893816862f, 0.02857174747f, -8.488510478e-05f, 1.578528016e-07f, -1.683534486e-10f, 1.110979401e-13f, -4.451543103e-17f, 9.897564082e-21f, -9.379133029e-25f}},
+};
+//Type B, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_B[] = {
+    {0.289f, 2.431f, 8, {98.423321f, 699.715f, -847.65304f, 1005.2644f, -833.45952f, 455.08542f, -155.23037f, 29.88675f, -2.474286f}},
+    {2.431f, 13.822f, 8, {213.15071f, 285.10504f, -52.742887f, 9.9160804f, -1.2965303f, 0.1119587f, -0.0060625199f, 0.00018661696f, -2.4878585e-06f}},
+};
+
+//Type E, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_E[] = {
+    {-270.0f, 0.0f, 13, {0.0f, 0.05866550871f, 4.541097712e-05f, -7.799804869e-07f, -2.580016084e-08f, -5.945258306e-10f, -9.321405867e-12f, -1.028760553e-13f, -8.037012362e-16f, -4.397949739e-18f, -1.641477635e-20f, -3.967361952e-23f, -5.582732872e-26f, -3.465784201e-29f}},
+    {0.0f, 1000.0f, 10, {0.0f, 0.05866550871f, 4.503227558e-05f, 2.890840721e-08f, -3.305689665e-10f, 6.502440327e-13f, -1.91974955e-16f, -1.25366005e-18f, 2.148921757e-21f, -1.438804178e-24f, 3.596089948e-28f}},
+};
+//Type E, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_E[] = {
+    {-8.827f, 0.0f, 8, {0.0f, 16.977288f, -0.4351497f, -0.15859697f, -0.092502871f, -0.026084314f, -0.0041360199f, -0.0003403403f, -1.156489e-05f}},
+    {0.0f, 76.375f, 9, {0.0f, 17.057035f, -0.23301759f, 0.0065435585f, -7.3562749e-05f, -1.7896001e-06f, 8.4036165e-08f, -1.3735879e-09f, 1.0629823e-11f, -3.2447087e-14f}},
+};
+
+//Type J, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_J[] = {
+    {-210.0f, 760.0f, 8, {0.0f, 0.05038118781f, 3.047583693e-05f, -8.568106572e-08f, 1.322819529e-10f, -1.705295834e-13f, 2.09480907e-16f, -1.253839534e-19f, 1.56317257e-23f}},
+    {760.0f, 1200.0f, 5, {296.4562568f, -1.497612779f, 0.003178710392f, -3.18476867e-06f, 1.5720819e-09f, -3.069136906e-13f}},
+};
+//Type J, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_J[] = {
+    {-8.097f, 0.0f, 8, {0.0f, 19.528268f, -1.2286185f, -1.0752178f, -0.59086933f, -0.17256713f, -0.028131513f, -0.002396337f, -8.3823321e-05f}},
+    {0.0f, 42.919f, 7, {0.0f, 19.78425f, -0.2001204f, 0.01036969f, -0.0002549687f, 3.585153e-06f, -5.344285e-08f, 5.09989e-10f}},
+    {42.919f, 69.555f, 5, {-3113.58187f, 300.543684f, -9.9477323f, 0.17027663f, -0.00143033468f, 4.73886084e-06f}},
+};
+
+//Type K, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_K[] = {
+    {-270.0f, 0.0f, 10, {0.0f, 0.03945012803f, 2.36223736e-05f, -3.285890678e-07f, -4.990482878e-09f, -6.750905917e-11f, -5.741032743e-13f, -3.108887289e-15f, -1.045160937e-17f, -1.988926688e-20f, -1.632269749e-23f}},
+    {0.0f, 1372.0f, 9, {-0.01760041369f, 0.03892120497f, 1.855877003e-05f, -9.945759287e-08f, 3.184094572e-10f, -5.607284489e-13f, 5.607505906e-16f, -3.202072e-19f, 9.715114715e-23f, -1.210472128e-26f}},
+};
+//Type K, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_K[] = {
+    {-5.893f, 0.0f, 8, {0.0f, 25.173462f, -1.1662878f, -1.0833638f, -0.8977354f, -0.37342377f, -0.086632643f, -0.010450598f, -0.00051920577f}},
+    {0.0f, 20.644f, 9, {0.0f, 25.08355f, 0.07860106f, -0.2503131f, 0.0831527f, -0.01228034f, 0.0009804036f, -4.41303e-05f, 1.057734e-06f, -1.052755e-08f}},
+    {20.644f, 54.888f, 6, {-131.8058f, 48.30222f, -1.646031f, 0.05464731f, -0.0009650715f, 8.802193e-06f, -3.11081e-08f}},
+};
+
+//Type N, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_N[] = {
+    {-270.0f, 0.0f, 8, {0.0f, 0.02615910596f, 1.095748423e-05f, -9.384111155e-08f, -4.641203976e-11f, -2.630335772e-12f, -2.2653438e-14f, -7.608930079e-17f, -9.341966783e-20f}},
+    {0.0f, 1300.0f, 10, {0.0f, 0.0259293946f, 1.571014188e-05f, 4.382562724e-08f, -2.526116979e-10f, 6.431181934e-13f, -1.006347152e-15f, 9.974533899e-19f, -6.086324561e-22f, 2.084922934e-25f, -3.068219615e-29f}},
+};
+//Type N, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_N[] = {
+    {-3.992f, 0.0f, 9, {0.0f, 38.436847f, 1.1010485f, 5.2229312f, 7.2060525f, 5.8488586f, 2.7754916f, 0.77075166f, 0.11582665f, 0.0073138868f}},
+    {0.0f, 20.613f, 7, {0.0f, 38.6896f, -1.08267f, 0.0470205f, -2.12169e-06f, -0.000117272f, 5.3928e-06f, -7.98156e-08f}},
+    {20.613f, 47.515f, 5, {19.72485f, 33.00943f, -0.3915159f, 0.009855391f, -0.0001274371f, 7.767022e-07f}},
+};
+
+//Type R, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_R[] = {
+    {-50.0f, 1064.18f, 9, {0.0f, 0.005289617298f, 1.391665898e-05f, -2.38855693e-08f, 3.569160011e-11f, -4.623476663e-14f, 5.00777441e-17f, -3.731058862e-20f, 1.577164824e-23f, -2.810386253e-27f}},
+    {1064.18f, 1664.5f, 5, {2.951579253f, -0.002520612513f, 1.595645019e-05f, -7.640859476e-09f, 2.05305291e-12f, -2.933596682e-16f}},
+    {1664.5f, 1768.1f, 4, {152.2321182f, -0.2688198885f, 0.0001712802805f, -3.458957065e-08f, -9.34633971e-15f}},
+};
+//Type R, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_R[] = {
+    {-0.228f, 1.923f, 10, {0.0f, 188.9138f, -93.83529f, 130.68619f, -227.0358f, 351.45659f, -389.539f, 282.39471f, -126.07281f, 31.353611f, -3.3187769f}},
+    {1.923f, 13.228f, 9, {13.34584505f, 147.2644573f, -18.44024844f, 4.031129726f, -0.624942836f, 0.06468412046f, -0.004458750426f, 0.0001994710149f, -5.31340179e-06f, 6.481976217e-08f}},
+    {11.361f, 19.739f, 5, {-81.99599416f, 155.3962042f, -8.342197663f, 0.4279433549f, -0.0119157791f, 0.0001492290091f}},
+    {19.739f, 21.105f, 4, {34061.77836f, -7023.729171f, 558.2903813f, -19.52394635f, 0.2560740231f}},
+};
+
+//Type S, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_S[] = {
+    {-50.0f, 1064.18f, 8, {0.0f, 0.005403133086f, 1.259342897e-05f, -2.324779687e-08f, 3.22028823e-11f, -3.314651964e-14f, 2.557442518e-17f, -1.250688714e-20f, 2.714431761e-24f}},
+    {1064.18f, 1664.5f, 4, {1.329004441f, 0.003345093113f, 6.548051928e-06f, -1.648562592e-09f, 1.299896052e-14f}},
+    {1664.5f, 1768.1f, 4, {146.6282326f, -0.2584305168f, 0.0001636935746f, -3.30439047e-08f, -9.432236906e-15f}},
+};
+//Type S, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_S[] = {
+    {-0.237f, 1.874f, 9, {0.0f, 184.94946f, -80.0504062f, 102.23743f, -152.248592f, 188.821343f, -159.085941f, 82.302788f, -23.4181944f, 2.7978626f}},
+    {1.874f, 11.95f, 9, {12.91507177f, 146.6298863f, -15.34713402f, 3.145945973f, -0.4163257839f, 0.03187963771f, -0.0012916375f, 2.183475087e-05f, -1.447379511e-07f, 8.211272125e-09f}},
+    {10.332f, 17.536f, 5, {-80.87801117f, 162.1573104f, -8.536869453f, 0.4719686976f, -0.01441693666f, 0.000208161889f}},
+    {17.536f, 18.695f, 4, {53338.75126f, -12358.92298f, 1092.657613f, -42.65693686f, 0.624720542f}},
+};
+
+//Type T, temperature in °C to voltage in mV
+static const MAX31856Polynomial forward_T[] = {
+    {-270.0f, 0.0f, 14, {0.0f, 0.03874810636f, 4.419443435e-05f, 1.18443231e-07f, 2.003297355e-08f, 9.013801956e-10f, 2.265115659e-11f, 3.607115421e-13f, 3.849393988e-15f, 2.821352193e-17f, 1.425159478e-19f, 4.876866229e-22f, 1.079553927e-24f, 1.394502706e-27f, 7.979515393e-31f}},
+    {0.0f, 400.0f, 8, {0.0f, 0.03874810636f, 3.329222788e-05f, 2.06182434e-07f, -2.188225685e-09f, 1.099688093e-11f, -3.081575877e-14f, 4.547913529e-17f, -2.751290167e-20f}},
+};
+//Type T, voltage in mV to temperature in °C
+static const MAX31856Polynomial inverse_T[] = {
+    {-5.605f, 0.0f, 7, {0.0f, 25.949192f, -0.21316967f, 0.79018692f, 0.42527777f, 0.13304473f, 0.020241446f, 0.0012668171f}},
+    {0.0f, 20.874f, 6, {0.0f, 25.928f, -0.7602961f, 0.04637791f, -0.002165394f, 6.048144e-05f, -7.293422e-07f}},
+};
+static const MAX31856Thermocouple thermocouples[8] = {
+    {forward_B, 2, inverse_B, 2, 0.0f, 0.0f, 0.0f},
+    {forward_E, 2, inverse_E, 2, 0.0f, 0.0f, 0.0f},
+    {forward_J, 2, inverse_J, 3, 0.0f, 0.0f, 0.0f},
+    {forward_K, 2, inverse_K, 3, 0.1185976f, -0.0001183432f, 126.9686f},
+    {forward_N, 2, inverse_N, 3, 0.0f, 0.0f, 0.0f},
+    {forward_R, 3, inverse_R, 4, 0.0f, 0.0f, 0.0f},
+    {forward_S, 3, inverse_S, 4, 0.0f, 0.0f, 0.0f},
+    {forward_T, 2, inverse_T, 2, 0.0f, 0.0f, 0.0f},
+};
+
+
+//*****************************************************************************
+const MAX31856Thermocouple* MAX31856Linearization::getThermocouple(uint8_t type)
+{
+    return (type < 8) ? &thermocouples[type] : NULL;   //CR1_TC_TYPE_B (0x00) to CR1_TC_TYPE_T (0x07)
+}
+
+
+//*****************************************************************************
+float MAX31856Linearization::temperatureToMillivolts(const MAX31856Thermocouple* tc, float temperature)
+{
+    for(uint8_t i=0; i<tc->forward_count; i++) {
+        const MAX31856Polynomial& poly = tc->forward[i];
+        if(temperature < poly.x_min || temperature > poly.x_max) continue;
+        float mv = evaluate(poly, temperature);
+        if(tc->a0 != 0.0f && poly.x_min >= 0.0f) {
+            float d = temperature - tc->a2;
+            mv += tc->a0 * expf(tc->a1 * d * d);
+        }
+        return mv;
+    }
+    return NAN;
+}
+
+
+//*****************************************************************************
+float MAX31856Linearization::millivoltsToTemperature(const MAX31856Thermocouple* tc, float mv)
+{
+    for(uint8_t i=0; i<tc->inverse_count; i++) {
+        const MAX31856Polynomial& poly = tc->inverse[i];
+        if(mv >= poly.x_min && mv <= poly.x_max) return evaluate(poly, mv);
+    }
+    return NAN;
+}
+
+
+//*****************************************************************************
+float MAX31856Linearization::compensate(const MAX31856Thermocouple* tc, float mv, float cold_junction)
+{
+    return millivoltsToTemperature(tc, mv + temperatureToMillivolts(tc, cold_junction));
+}
+
+
+//*****************************************************************************
+void MAX31856Linearization::compensateBatch(const MAX31856Thermocouple* tc, const float* mv, const float* cold_junction, float* out, uint32_t n)
+{
+    float sum[MAX31856_BATCH_CHUNK];
+    float cj_mv[MAX31856_BATCH_CHUNK];
+    for(uint32_t base=0; base<n; base+=MAX31856_BATCH_CHUNK) {
+        uint32_t m = (n - base < MAX31856_BATCH_CHUNK) ? n - base : MAX31856_BATCH_CHUNK;
+        const float* cj = &cold_junction[base];
+        evaluateRanges(tc->forward, tc->forward_count, cj, cj_mv, m);
+        if(tc->a0 != 0.0f) {    //exponential term of type K, only in the ranges above 0 °C like temperatureToMillivolts()
+            for(uint32_t k=0; k<m; ) {
+                uint8_t range = findRange(tc->forward, tc->forward_count, cj[k]);
+                uint32_t end = findRunEnd(tc->forward, tc->forward_count, range, cj, k, m);
+                if(range < tc->forward_count && tc->forward[range].x_min >= 0.0f) {
+                    for(; k<end; k++) {
+                        float d = cj[k] - tc->a2;
+                        cj_mv[k] += tc->a0 * expf(tc->a1 * d * d);
+                    }
+                }
+                k = end;
+            }
+        }
+        for(uint32_t k=0; k<m; k++) sum[k] = mv[base+k] + cj_mv[k];     //copied before out is written, out may be mv
+        evaluateRanges(tc->inverse, tc->inverse_count, sum, &out[base], m);
+    }
+}
+
+
+//*****************************************************************************
+uint8_t MAX31856Linearization::findRange(const MAX31856Polynomial* ranges, uint8_t count, float x)
+{
+    for(uint8_t i=0; i<count; i++)
+        if(x >= ranges[i].x_min && x <= ranges[i].x_max) return i;
+    return count;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856Linearization::findRunEnd(const MAX31856Polynomial* ranges, uint8_t count, uint8_t range, const float* x, uint32_t start, uint32_t n)
+{
+    uint32_t end = start + 1;
+    while(end < n && findRange(ranges, count, x[end]) == range) end++;
+    return end;
+}
+
+
+//*****************************************************************************
+void MAX31856Linearization::evaluateRun(const MAX31856Polynomial& poly, const float* x, float* y, uint32_t n)
+{
+    float c = poly.c[poly.order];
+    for(uint32_t k=0; k<n; k++) y[k] = c;
+    for(int i=poly.order-1; i>=0; i--) {     //Horner's scheme one coefficient at a time over the whole run
+        c = poly.c[i];
+        for(uint32_t k=0; k<n; k++) y[k] = y[k]*x[k] + c;
+    }
+}
+
+
+//*****************************************************************************
+void MAX31856Linearization::evaluateRanges(const MAX31856Polynomial* ranges, uint8_t count, const float* x, float* y, uint32_t n)
+{
+    for(uint32_t k=0; k<n; ) {
+        uint8_t range = findRange(ranges, count, x[k]);
+        uint32_t end = findRunEnd(ranges, count, range, x, k, n);
+        if(range < count) evaluateRun(ranges[range], &x[k], &y[k], end - k);
+        else for(uint32_t i=k; i<end; i++) y[i] = NAN;
+        k = end;
+    }
+}
+
+
+//*****************************************************************************
+MAX31856LinearTable::MAX31856LinearTable(uint8_t type)
+{
+    build(MAX31856Linearization::getThermocouple(type));
+}
+
+
+//*****************************************************************************
+MAX31856LinearTable::MAX31856LinearTable(const MAX31856Thermocouple* tc)
+{
+    build(tc);
+}
+
+
+//*****************************************************************************
+void MAX31856LinearTable::build(const MAX31856Thermocouple* tc)
+{
+    thermocouple = tc;
+    mv_min = 0.0f;
+    inv_step = 0.0f;
+    if(!tc) return;
+    mv_min = tc->inverse[0].x_min;
+    float mv_max = tc->inverse[tc->inverse_count-1].x_max;
+    float step = (mv_max - mv_min) / (MAX31856_LUT_SIZE - 1);
+    inv_step = 1.0f / step;
+    for(uint32_t i=0; i<MAX31856_LUT_SIZE; i++) {
+        float mv = (i == MAX31856_LUT_SIZE-1) ? mv_max : mv_min + i*step;  //avoid rounding the last point out of range
+        temperature[i] = MAX31856Linearization::millivoltsToTemperature(tc, mv);
+    }
+    for(int i=0; i<=MAX31856_LUT_CJ_MAX-MAX31856_LUT_CJ_MIN; i++)
+        cj_millivolts[i] = MAX31856Linearization::temperatureToMillivolts(tc, (float)(i + MAX31856_LUT_CJ_MIN));
+}
+
+
+//*****************************************************************************
+inline float MAX31856LinearTable::interpolate(float mv) const
+{
+    float x = (mv - mv_min) * inv_step;
+    if(!(x >= 0.0f && x <= (float)(MAX31856_LUT_SIZE-1))) return NAN;   //also rejects NAN
+    uint32_t i = (uint32_t)x;
+    if(i == MAX31856_LUT_SIZE-1) i--;
+    float frac = x - i;
+    return temperature[i] + frac * (temperature[i+1] - temperature[i]);
+}
+
+
+//*****************************************************************************
+inline float MAX31856LinearTable::coldJunctionMillivolts(float cj) const
+{
+    float cj_index = cj - MAX31856_LUT_CJ_MIN;
+    if(!(cj_index >= 0.0f && cj_index <= (float)(MAX31856_LUT_CJ_MAX-MAX31856_LUT_CJ_MIN))) return NAN;
+    uint32_t i = (uint32_t)cj_index;
+    if(i == MAX31856_LUT_CJ_MAX-MAX31856_LUT_CJ_MIN) i--;
+    return cj_millivolts[i] + (cj_index - i) * (cj_millivolts[i+1] - cj_millivolts[i]);
+}
+
+
+//*****************************************************************************
+float MAX31856LinearTable::convert(int32_t raw, int16_t cj, uint8_t gain) const
+{
+    if(!thermocouple) return NAN;
+    return interpolate(MAX31856Linearization::codeToMillivolts(raw, gain) + coldJunctionMillivolts(cj * 0.00390625f));  //1/256 °C to °C
+}
+
+
+//*****************************************************************************
+void MAX31856LinearTable::convertBatch(const int32_t* raw, const int16_t* cj, float* out, uint32_t n, uint8_t gain) const
+{
+    for(uint32_t i=0; i<n; i++) out[i] = convert(raw[i], cj[i], gain);
+}
+
+
+//*****************************************************************************
+float MAX31856LinearTable::maxError() const
+{
+    if(!thermocouple) return NAN;
+    //largest errors of the cold junction table in mV, at the middle of its intervals
+    float cj_low = 0.0f, cj_high = 0.0f;
+    for(int c=MAX31856_LUT_CJ_MIN; c<MAX31856_LUT_CJ_MAX; c++) {
+        float cj = c + 0.5f;
+        float error = coldJunctionMillivolts(cj) - MAX31856Linearization::temperatureToMillivolts(thermocouple, cj);
+        cj_low = fminf(cj_low, error);
+        cj_high = fmaxf(cj_high, error);
+    }
+    //voltage table at MAX31856_LUT_CHECK_POINTS points inside each interval, and on both sides of the ends of the polynomial
+    //ranges where the NIST polynomials do not join smoothly, shifted by either extreme of the cold junction error
+    float max_error = 0.0f;
+    uint32_t points = (MAX31856_LUT_SIZE-1) * MAX31856_LUT_CHECK_POINTS;
+    for(uint32_t i=0; i<points + thermocouple->inverse_count*4; i++) {
+        float mv;
+        if(i < points) mv = mv_min + (i + 0.5f) / (inv_step * MAX31856_LUT_CHECK_POINTS);
+        else {
+            uint32_t e = i - points;
+            const MAX31856Polynomial& range = thermocouple->inverse[e / 4];
+            mv = (e & 2) ? range.x_max : range.x_min;
+            mv = nextafterf(mv, (e & 1) ? INFINITY : -INFINITY);
+        }
+        float exact = MAX31856Linearization::millivoltsToTemperature(thermocouple, mv);
+        float error = fmaxf(fabsf(interpolate(mv + cj_low) - exact), fabsf(interpolate(mv + cj_high) - exact));  //NAN outside the table is skipped
+        if(error > max_error) max_error = error;
+    }
+    return max_error;
+}
@@ -0,0 +1,277 @@
+/******************************************************************//**
+* @file lib_MAX31856_linear.h
+*
+* @version 1.0
+*
+* @brief Header file for MAX31856Linearization class
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_LINEAR_h
+#define MAX31856_LINEAR_h
+#include <stdint.h>
+#include <math.h>
+
+//*****************************************************************************   
+///Parameters that are used throughout the linearization
+//*****************************************************************************   
+#define MAX31856_POLY_MAX_ORDER            14      //highest order of the NIST polynomials (type E and T below 0 °C)
+#define MAX31856_VOLTAGE_GAIN_8            8
+#define MAX31856_VOLTAGE_GAIN_32           32
+#define MAX31856_LUT_SIZE                  1024    //points of the voltage to temperature table of MAX31856LinearTable
+#define MAX31856_LUT_CHECK_POINTS          16      //points checked by MAX31856LinearTable::maxError() in each interval of the table
+#define MAX31856_LUT_CJ_MIN                (-55)   //cold junction range of the MAX31856 in °C, 1 point per °C
+#define MAX31856_LUT_CJ_MAX                125
+#define MAX31856_BATCH_CHUNK               64      //elements converted together by compensateBatch(), on the stack
+
+
+/** @brief Polynomial sum(c[i] * x^i) valid for x_min <= x <= x_max */
+struct MAX31856Polynomial {
+    float x_min;                                ///< Lower bound of the range of the polynomial
+    float x_max;                                ///< Upper bound of the range of the polynomial
+    uint8_t order;                              ///< Highest power of x
+    float c[MAX31856_POLY_MAX_ORDER+1];         ///< Coefficients from the power 0 to the power order
+};
+
+
+/** 
+ * @brief Description of a thermocouple by piecewise polynomials\n
+ * The built-in types come from the NIST ITS-90 thermocouple database (NIST Monograph 175), a custom
+ * thermocouple is described the same way with its own coefficients.
+ */
+struct MAX31856Thermocouple {
+    const MAX31856Polynomial* forward;          ///< Temperature in °C to voltage in mV, ranges sorted by temperature
+    uint8_t forward_count;                      ///< Number of forward ranges
+    const MAX31856Polynomial* inverse;          ///< Voltage in mV to temperature in °C, ranges sorted by voltage
+    uint8_t inverse_count;                      ///< Number of inverse ranges
+    float a0, a1, a2;                           ///< a0 * exp(a1 * (t - a2)^2) added to the forward ranges starting at 0 °C (type K only, 0 otherwise)
+};
+
+
+/**
+ * @brief Software linearization and cold junction compensation for the voltage mode of the MAX31856\n
+ * The MAX31856 linearizes types B, E, J, K, N, R, S and T itself with an accuracy of ±0.7 °C. In voltage mode
+ * (CR1_TC_TYPE_VOLT_MODE_GAIN_8 or CR1_TC_TYPE_VOLT_MODE_GAIN_32) it only reports the thermocouple voltage,
+ * these functions add the voltage of the cold junction and evaluate the NIST inverse polynomials by Horner's scheme,
+ * which stays within 0.1 °C of the NIST tables over the whole range of each type.
+ * All functions are reentrant, use single precision only and do not depend on mbed so they also run on a PC.
+ *
+ * @code
+ * Thermocouple1.setThermocoupleType(CR1_TC_TYPE_VOLT_MODE_GAIN_8);
+ * Thermocouple1.setSoftwareLinearization(MAX31856Linearization::getThermocouple(CR1_TC_TYPE_K));
+ * float temperature = Thermocouple1.readTC();
+ * @endcode
+ */
+class MAX31856Linearization
+{
+
+public:
+    /** 
+    * @brief  Returns the NIST ITS-90 description of a thermocouple type
+    * @param type - CR1_TC_TYPE_B to CR1_TC_TYPE_T
+    * @return pointer to the description, NULL for any other value
+    */
+    static const MAX31856Thermocouple* getThermocouple(uint8_t type);
+    
+    
+    /** 
+    * @brief  Evaluates a polynomial by Horner's scheme
+    * @param poly - Polynomial to evaluate
+    * @param x - Value of the variable, not checked against the range of the polynomial
+    * @return value of the polynomial
+    */
+    static inline float evaluate(const MAX31856Polynomial& poly, float x)
+    {
+        float y = poly.c[poly.order];
+        for(int i=poly.order-1; i>=0; i--) y = y*x + poly.c[i];
+        return y;
+    }
+    
+    
+    /** 
+    * @brief  Thermoelectric voltage of a thermocouple at a temperature, the cold junction being at 0 °C
+    * @param tc - Thermocouple description
+    * @param temperature - Temperature in °C
+    * @return voltage in mV, NAN if the temperature is outside every range of the description
+    */
+    static float temperatureToMillivolts(const MAX31856Thermocouple* tc, float temperature);
+    
+    
+    /** 
+    * @brief  Temperature of a thermocouple producing a voltage, the cold junction being at 0 °C
+    * @param tc - Thermocouple description
+    * @param mv - Voltage in mV
+    * @return temperature in °C, NAN if the voltage is outside every range of the description
+    */
+    static float millivoltsToTemperature(const MAX31856Thermocouple* tc, float mv);
+    
+    
+    /** 
+    * @brief  Cold junction compensated temperature: converts the cold junction temperature to a voltage, adds it to the thermocouple voltage and converts the sum back
+    * @param tc - Thermocouple description
+    * @param mv - Thermocouple voltage in mV measured in voltage mode
+    * @param cold_junction - Cold junction temperature in °C
+    * @return temperature of the hot junction in °C, NAN if out of range
+    */
+    static float compensate(const MAX31856Thermocouple* tc, float mv, float cold_junction);
+    
+    
+    /** 
+    * @brief  compensate() applied to arrays\n
+    *         Consecutive elements in the same range of the description are evaluated together, one coefficient at a time over
+    *         the whole run in a branch free loop the compiler vectorizes. Batches of slowly varying samples form long runs
+    * @param tc - Thermocouple description
+    * @param mv - Thermocouple voltages in mV
+    * @param cold_junction - Cold junction temperatures in °C
+    * @param out - Receives the temperatures in °C, may be the same array as mv
+    * @param n - Number of elements
+    */
+    static void compensateBatch(const MAX31856Thermocouple* tc, const float* mv, const float* cold_junction, float* out, uint32_t n);
+    
+    
+    /** 
+    * @brief  Converts a raw voltage mode value of the LTCB registers into mV, VIN = code / (gain x 1.6 x 2^17)
+    * @param raw - Signed 19 bits value of LTCBH, LTCBM and LTCBL as returned by MAX31856::readTCRaw()
+    * @param gain - MAX31856_VOLTAGE_GAIN_8 or MAX31856_VOLTAGE_GAIN_32
+    * @return voltage in mV
+    */
+    static inline float codeToMillivolts(int32_t raw, uint8_t gain)
+    {
+        return raw * (1000.0f / (1.6f * 131072.0f)) / gain;
+    }
+
+private:
+    /** @brief  Index of the first range containing x, count if none does */
+    static uint8_t findRange(const MAX31856Polynomial* ranges, uint8_t count, float x);
+    
+    /** @brief  End of the run of elements from start that findRange() puts in the same range */
+    static uint32_t findRunEnd(const MAX31856Polynomial* ranges, uint8_t count, uint8_t range, const float* x, uint32_t start, uint32_t n);
+    
+    /** @brief  Evaluates a polynomial on n values, y must not overlap x */
+    static void evaluateRun(const MAX31856Polynomial& poly, const float* x, float* y, uint32_t n);
+    
+    /** @brief  Evaluates piecewise polynomials on n values run by run, NAN outside every range */
+    static void evaluateRanges(const MAX31856Polynomial* ranges, uint8_t count, const float* x, float* y, uint32_t n);
+};
+
+
+/**
+ * @brief Lookup table version of MAX31856Linearization::compensate() for converting large batches of raw voltage mode samples\n
+ * The constructor evaluates the NIST polynomials once into a table of MAX31856_LUT_SIZE points over the voltage range
+ * and a table of the cold junction voltage over the range of the MAX31856, conversions then only interpolate linearly.
+ * The tables take about 4.8 kB, so the object is best created once and kept (static or on the heap on small targets).
+ * The interpolation differs from compensate() by less than 0.07 °C for every type, most where two NIST polynomials meet
+ * (0.062 °C for type J at 760 °C), see maxError().
+ *
+ * @code
+ * static MAX31856LinearTable table(CR1_TC_TYPE_K);
+ * table.convertBatch(raw, cj, temperatures, count, MAX31856_VOLTAGE_GAIN_8);
+ * @endcode
+ */
+class MAX31856LinearTable
+{
+
+public:
+    /** 
+    * @brief  Builds the tables of a thermocouple type
+    * @param type - CR1_TC_TYPE_B to CR1_TC_TYPE_T, any other value leaves the table empty and every conversion returns NAN
+    */
+    MAX31856LinearTable(uint8_t type);
+    
+    
+    /** 
+    * @brief  Builds the tables of a custom thermocouple description
+    * @param tc - Thermocouple description, NULL leaves the table empty
+    */
+    MAX31856LinearTable(const MAX31856Thermocouple* tc);
+    
+    
+    /** 
+    * @brief  Converts a raw voltage mode reading and its cold junction into °C
+    * @param raw - Signed 19 bits value as returned by MAX31856::readTCRaw() or stored in MAX31856::Sample
+    * @param cj - Cold junction in 1/256 °C as returned by MAX31856::readCJRaw()
+    * @param gain - MAX31856_VOLTAGE_GAIN_8 or MAX31856_VOLTAGE_GAIN_32
+    * @return temperature in °C, NAN if the compensated voltage or the cold junction is outside the table
+    */
+    float convert(int32_t raw, int16_t cj, uint8_t gain) const;
+    
+    
+    /** 
+    * @brief  convert() applied to arrays, for archives of raw samples
+    * @param raw - Raw thermocouple values
+    * @param cj - Raw cold junction values
+    * @param out - Receives the temperatures in °C
+    * @param n - Number of elements
+    * @param gain - MAX31856_VOLTAGE_GAIN_8 or MAX31856_VOLTAGE_GAIN_32
+    */
+    void convertBatch(const int32_t* raw, const int16_t* cj, float* out, uint32_t n, uint8_t gain) const;
+    
+    
+    /** 
+    * @brief  Checks convert() against MAX31856Linearization::compensate() over the whole range of both tables\n
+    *         The voltage table is checked at the middle of every interval, where the interpolation error is largest,
+    *         together with the largest errors of the cold junction table, also found at the middle of its intervals
+    * @return largest difference in °C between convert() and compensate() before the quantization of the raw values
+    */
+    float maxError() const;
+
+private:
+    /** @brief  Evaluates the polynomials into the tables */
+    void build(const MAX31856Thermocouple* tc);
+    
+    /** @brief  Interpolates the voltage to temperature table, NAN outside */
+    inline float interpolate(float mv) const;
+    
+    /** @brief  Interpolates the cold junction voltage table, cj in °C, NAN outside */
+    inline float coldJunctionMillivolts(float cj) const;
+    
+    
+    ///Thermocouple the tables were built from, NULL if empty
+    const MAX31856Thermocouple* thermocouple;
+    
+    ///Voltage of the first point of the table in mV
+    float mv_min;
+    
+    ///Points per mV
+    float inv_step;
+    
+    ///Temperature in °C at each point of the voltage range
+    float temperature[MAX31856_LUT_SIZE];
+    
+    ///Voltage of the cold junction in mV for each °C from MAX31856_LUT_CJ_MIN to MAX31856_LUT_CJ_MAX
+    float cj_millivolts[MAX31856_LUT_CJ_MAX-MAX31856_LUT_CJ_MIN+1];
+};
+
+#endif  /* MAX31856_LINEAR_h */
@@ -0,0 +1,340 @@
+/******************************************************************//**
+* @file lib_MAX31856_log.cpp
+*
+* @version 1.0
+*
+* @brief Source file for MAX31856LogEncoder and MAX31856LogDecoder classes
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "lib_MAX31856_log.h"
+#include <string.h>
+
+//*****************************************************************************
+//Byte level helpers shared by the encoder and the decoder
+//*****************************************************************************
+static inline uint32_t zigzag(int32_t val)
+{
+    return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);    //small magnitudes of either sign give small codes
+}
+
+static inline int32_t unzigzag(uint32_t code)
+{
+    return (int32_t)((code >> 1) ^ (0u - (code & 1)));
+}
+
+static inline uint8_t* putVarint(uint8_t* p, uint32_t val)
+{
+    while(val >= 0x80) {
+        *p++ = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    *p++ = (uint8_t)val;
+    return p;
+}
+
+//returns 0 if the varint runs past end or is longer than 5 bytes
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& val)
+{
+    val = 0;
+    for(uint8_t shift=0; shift<35 && p<end; shift+=7) {
+        uint8_t b = *p++;
+        val |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static inline void put16(uint8_t* p, uint16_t val)
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+}
+
+static inline void put32(uint8_t* p, uint32_t val)
+{
+    put16(p, (uint16_t)val);
+    put16(p+2, (uint16_t)(val >> 16));
+}
+
+static inline uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get32(const uint8_t* p)
+{
+    return get16(p) | ((uint32_t)get16(p+2) << 16);
+}
+
+//Offsets of the fields of the block header
+#define LOG_MAGIC_OFFSET                   0
+#define LOG_VERSION_OFFSET                 2
+#define LOG_CR0_OFFSET                     3
+#define LOG_CR1_OFFSET                     4
+#define LOG_FLAGS_OFFSET                   5
+#define LOG_COUNT_OFFSET                   6
+#define LOG_SAMPLE_BYTES_OFFSET            8
+#define LOG_PAYLOAD_BYTES_OFFSET           10
+#define LOG_TIMESTAMP_OFFSET               12
+
+
+//*****************************************************************************
+MAX31856LogEncoder::MAX31856LogEncoder(uint8_t _cr0, uint8_t _cr1) : cr0(_cr0), cr1(_cr1)
+{
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogEncoder::add(uint32_t timestamp_us, int32_t tc_raw, int16_t cj_raw, uint8_t sr)
+{
+    if(closed) {
+        closed = false;
+        count = 0;
+        sample_len = 0;
+        run_len = 0;
+    }
+    if(!count) {    //changes of the first sample of a block are relative to 0 and to the timestamp of the header
+        put32(&block[LOG_TIMESTAMP_OFFSET], timestamp_us);
+        prev_tc = 0;
+        prev_cj = 0;
+        prev_timestamp = timestamp_us;
+        prev_interval = 0;
+        run_sr = sr;
+        run_count = 0;
+    }
+    uint32_t interval = timestamp_us - prev_timestamp;
+    uint8_t* p = &block[MAX31856_LOG_HEADER_SIZE + sample_len];
+    p = putVarint(p, zigzag((int32_t)((uint32_t)tc_raw - (uint32_t)prev_tc)));
+    p = putVarint(p, zigzag((int32_t)cj_raw - prev_cj));
+    p = putVarint(p, zigzag((int32_t)(interval - prev_interval)));
+    sample_len = p - &block[MAX31856_LOG_HEADER_SIZE];
+    prev_tc = tc_raw;
+    prev_cj = cj_raw;
+    prev_timestamp = timestamp_us;
+    prev_interval = interval;
+    if(sr != run_sr) {
+        closeRun();
+        run_sr = sr;
+    }
+    run_count++;
+    count++;
+    //close now if the worst case of the next sample might not fit
+    if(MAX31856_LOG_HEADER_SIZE + sample_len + MAX31856_LOG_SAMPLE_MAX_BYTES + run_len + 2*MAX31856_LOG_RUN_MAX_BYTES + MAX31856_LOG_CRC_SIZE > MAX31856_LOG_BLOCK_SIZE
+       || run_len + 2*MAX31856_LOG_RUN_MAX_BYTES > MAX31856_LOG_RUN_BYTES || count == UINT16_MAX)
+        return closeBlock();
+    return 0;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogEncoder::setConfig(uint8_t _cr0, uint8_t _cr1)
+{
+    uint32_t len = flush();
+    cr0 = _cr0;
+    cr1 = _cr1;
+    return len;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogEncoder::flush()
+{
+    return (closed || !count) ? 0 : closeBlock();
+}
+
+
+//*****************************************************************************
+const uint8_t* MAX31856LogEncoder::getBlock() const
+{
+    return block;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogEncoder::getBlockCount() const
+{
+    return block_count;
+}
+
+
+//*****************************************************************************
+void MAX31856LogEncoder::closeRun()
+{
+    runs[run_len++] = run_sr;
+    run_len = putVarint(&runs[run_len], run_count) - runs;
+    run_count = 0;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogEncoder::closeBlock()
+{
+    closeRun();
+    uint32_t payload_len = sample_len + run_len;
+    memcpy(&block[MAX31856_LOG_HEADER_SIZE + sample_len], runs, run_len);
+    put16(&block[LOG_MAGIC_OFFSET], MAX31856_LOG_MAGIC);
+    block[LOG_VERSION_OFFSET] = MAX31856_LOG_VERSION;
+    block[LOG_CR0_OFFSET] = cr0;
+    block[LOG_CR1_OFFSET] = cr1;
+    block[LOG_FLAGS_OFFSET] = 0;
+    put16(&block[LOG_COUNT_OFFSET], count);
+    put16(&block[LOG_SAMPLE_BYTES_OFFSET], (uint16_t)sample_len);
+    put16(&block[LOG_PAYLOAD_BYTES_OFFSET], (uint16_t)payload_len);
+    uint32_t len = MAX31856_LOG_HEADER_SIZE + payload_len;
+    put32(&block[len], MAX31856LogDecoder::crc32(block, len));
+    closed = true;
+    block_count++;
+    return len + MAX31856_LOG_CRC_SIZE;
+}
+
+
+//*****************************************************************************
+MAX31856LogDecoder::MAX31856LogDecoder(const uint8_t* _data, size_t _size) : data(_data), size(_size)
+{
+}
+
+
+//*****************************************************************************
+bool MAX31856LogDecoder::next(MAX31856LogRecord& record)
+{
+    while(true) {
+        while(!samples_left)
+            if(!openBlock()) return false;
+        uint32_t dtc, dcj, dinterval;
+        if(!getVarint(sample_ptr, sample_end, dtc) || !getVarint(sample_ptr, sample_end, dcj) || !getVarint(sample_ptr, sample_end, dinterval)) {
+            samples_left = 0;   //inconsistent block despite its CRC, drop the rest of it
+            corrupt_count++;
+            continue;
+        }
+        if(!run_left) {
+            if(run_ptr >= run_end || !(run_sr = *run_ptr++, getVarint(run_ptr, run_end, run_left)) || !run_left) {
+                samples_left = 0;
+                corrupt_count++;
+                continue;
+            }
+        }
+        run_left--;
+        samples_left--;
+        prev_tc = (int32_t)((uint32_t)prev_tc + (uint32_t)unzigzag(dtc));
+        prev_cj = (int16_t)(prev_cj + unzigzag(dcj));
+        prev_interval += (uint32_t)unzigzag(dinterval);
+        prev_timestamp += prev_interval;
+        record.timestamp_us = prev_timestamp;
+        record.tc_raw = prev_tc;
+        record.cj_raw = prev_cj;
+        record.sr = run_sr;
+        record.cr0 = cr0;
+        record.cr1 = cr1;
+        return true;
+    }
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogDecoder::read(MAX31856LogRecord* records, uint32_t max_count)
+{
+    uint32_t n = 0;
+    while(n < max_count && next(records[n])) n++;
+    return n;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogDecoder::getBlockCount() const
+{
+    return block_count;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogDecoder::getCorruptCount() const
+{
+    return corrupt_count;
+}
+
+
+//*****************************************************************************
+uint32_t MAX31856LogDecoder::crc32(const uint8_t* data, size_t len)
+{
+    static const uint32_t table[16] = {     //reflected polynomial 0xEDB88320, one nibble at a time
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i=0; i<len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+
+//*****************************************************************************
+bool MAX31856LogDecoder::openBlock()
+{
+    bool in_gap = false;    //a run of bytes that are not a valid block counts as one corrupt block
+    while(pos + MAX31856_LOG_HEADER_SIZE + MAX31856_LOG_CRC_SIZE <= size) {
+        const uint8_t* p = &data[pos];
+        uint32_t payload_len = get16(&p[LOG_PAYLOAD_BYTES_OFFSET]);
+        uint32_t sample_len = get16(&p[LOG_SAMPLE_BYTES_OFFSET]);
+        uint32_t len = MAX31856_LOG_HEADER_SIZE + payload_len;
+        if(get16(&p[LOG_MAGIC_OFFSET]) != MAX31856_LOG_MAGIC || p[LOG_VERSION_OFFSET] != MAX31856_LOG_VERSION
+           || payload_len > MAX31856_LOG_BLOCK_SIZE - MAX31856_LOG_HEADER_SIZE - MAX31856_LOG_CRC_SIZE     //never written by the encoder, no CRC over a corrupt length
+           || sample_len > payload_len || pos + len + MAX31856_LOG_CRC_SIZE > size || crc32(p, len) != get32(&p[len])) {
+            if(!in_gap) corrupt_count++;
+            in_gap = true;
+            pos++;      //search the next block byte by byte
+            continue;
+        }
+        cr0 = p[LOG_CR0_OFFSET];
+        cr1 = p[LOG_CR1_OFFSET];
+        samples_left = get16(&p[LOG_COUNT_OFFSET]);
+        sample_ptr = &p[MAX31856_LOG_HEADER_SIZE];
+        sample_end = run_ptr = sample_ptr + sample_len;
+        run_end = &p[len];
+        run_left = 0;
+        prev_tc = 0;
+        prev_cj = 0;
+        prev_timestamp = get32(&p[LOG_TIMESTAMP_OFFSET]);
+        prev_interval = 0;
+        pos += len + MAX31856_LOG_CRC_SIZE;
+        block_count++;
+        return true;
+    }
+    if(pos < size && !in_gap) corrupt_count++;  //truncated end of the log
+    pos = size;
+    return false;
+}
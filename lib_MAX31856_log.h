@@ -0,0 +1,283 @@
+/******************************************************************//**
+* @file lib_MAX31856_log.h
+*
+* @version 1.0
+*
+* @brief Header file for MAX31856LogEncoder and MAX31856LogDecoder classes
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_LOG_h
+#define MAX31856_LOG_h
+#include <stdint.h>
+#include <stddef.h>
+
+//*****************************************************************************   
+///Parameters of the log format, the encoder and the decoder must agree on them
+//*****************************************************************************   
+#define MAX31856_LOG_MAGIC                 0x3856  //first two bytes of a block, little endian
+#define MAX31856_LOG_VERSION               1
+#define MAX31856_LOG_HEADER_SIZE           16
+#define MAX31856_LOG_CRC_SIZE              4
+#define MAX31856_LOG_BLOCK_SIZE            512     //largest block written by the encoder, a flash page
+#define MAX31856_LOG_RUN_BYTES             64      //room for the fault status runs of one block
+#define MAX31856_LOG_SAMPLE_MAX_BYTES      15      //3 varints of up to 5 bytes
+#define MAX31856_LOG_RUN_MAX_BYTES         4       //status byte and a varint of up to 3 bytes
+
+
+/** @brief Sample decoded from a log, with the configuration of its block */
+struct MAX31856LogRecord {
+    uint32_t timestamp_us;          ///< Time of the reading in microseconds, as in MAX31856::Sample
+    int32_t tc_raw;                 ///< Thermocouple in 1/128 °C, as returned by MAX31856::readTCRaw()
+    int16_t cj_raw;                 ///< Cold junction in 1/256 °C, as returned by MAX31856::readCJRaw()
+    uint8_t sr;                     ///< Fault status register
+    uint8_t cr0;                    ///< Configuration register 0 when the sample was taken
+    uint8_t cr1;                    ///< Configuration register 1 when the sample was taken
+};
+
+
+/**
+ * @brief Streaming encoder of the compact sample log, for weeks long captures to flash\n
+ * The log is a sequence of independent blocks of at most MAX31856_LOG_BLOCK_SIZE bytes:
+ *      \li Header: magic, version, CR0, CR1, flags, sample count, sample bytes, payload bytes, timestamp of the first sample
+ *          (16 bytes, little endian)
+ *      \li Samples: per sample the change of TC, the change of CJ and the change of the interval between timestamps,
+ *          each zigzag varint encoded, a steady reading at a steady rate takes 3 bytes
+ *      \li Fault status runs: status byte followed by the varint number of consecutive samples having it
+ *      \li CRC-32 of header and payload
+ *
+ * Only needs stdint.h, the same sources build on the MCU and on a host reading the logs.
+ *
+ * @code
+ * MAX31856LogEncoder log(Thermocouple1.registerReadByte(ADDRESS_CR0_READ), Thermocouple1.registerReadByte(ADDRESS_CR1_READ));
+ *
+ * MAX31856::Sample sample;
+ * if(Thermocouple1.readSample(sample)) {
+ *      uint32_t len = log.add(sample.timestamp_us, sample.tc_raw, sample.cj_raw, sample.sr);
+ *      if(len)
+ *          flash.program(log.getBlock(), address, len);
+ * }
+ * @endcode
+ */
+class MAX31856LogEncoder
+{
+
+public:
+    /** 
+    * @brief  Constructor of an encoder with an empty block
+    * @param _cr0 - Configuration register 0 written in the block headers
+    * @param _cr1 - Configuration register 1 written in the block headers
+    */
+    MAX31856LogEncoder(uint8_t _cr0, uint8_t _cr1);
+    
+    
+    /** 
+    * @brief  Adds a sample to the current block, closes the block when another sample might not fit\n
+    *         The closed block stays in getBlock() until the next call of add(), store it before
+    * @param timestamp_us - Time of the reading in microseconds
+    * @param tc_raw - Thermocouple in 1/128 °C
+    * @param cj_raw - Cold junction in 1/256 °C
+    * @param sr - Fault status register
+    * @return length in bytes of the block closed by this sample, 0 if the block is still open
+    */
+    uint32_t add(uint32_t timestamp_us, int32_t tc_raw, int16_t cj_raw, uint8_t sr);
+    
+    
+    /** 
+    * @brief  Closes the current block so the following samples are logged with a new configuration
+    * @param _cr0 - New configuration register 0
+    * @param _cr1 - New configuration register 1
+    * @return length in bytes of the block closed, 0 if it was empty
+    */
+    uint32_t setConfig(uint8_t _cr0, uint8_t _cr1);
+    
+    
+    /** 
+    * @brief  Closes the current block, at the end of a capture or before a power down
+    * @return length in bytes of the block closed, 0 if it was empty
+    */
+    uint32_t flush();
+    
+    
+    /** @return the last closed block, valid until the next call of add() */
+    const uint8_t* getBlock() const;
+    
+    
+    /** @return number of blocks closed since construction */
+    uint32_t getBlockCount() const;
+    
+
+private:
+    /** @brief  Appends the open fault status run to the runs of the block */
+    void closeRun();
+    
+    /** @brief  Writes the runs, the header and the CRC, returns the length of the block */
+    uint32_t closeBlock();
+    
+    
+    ///Block being encoded: header, samples, then runs and CRC once closed
+    uint8_t block[MAX31856_LOG_BLOCK_SIZE];
+    
+    ///Fault status runs of the open block, copied after the samples when the block is closed
+    uint8_t runs[MAX31856_LOG_RUN_BYTES];
+    
+    ///Bytes of samples after the header and bytes of closed runs
+    uint32_t sample_len = 0;
+    uint32_t run_len = 0;
+    
+    ///Samples in the open block
+    uint16_t count = 0;
+    
+    ///1=block holds a closed block, the next sample starts a new one
+    bool closed = false;
+    
+    ///Previous sample the changes are computed from
+    int32_t prev_tc = 0;
+    int16_t prev_cj = 0;
+    uint32_t prev_timestamp = 0;
+    uint32_t prev_interval = 0;
+    
+    ///Fault status of the open run and number of samples in it
+    uint8_t run_sr = 0;
+    uint32_t run_count = 0;
+    
+    uint8_t cr0, cr1;
+    uint32_t block_count = 0;
+};
+
+
+/**
+ * @brief Decoder of the compact sample log, over a buffer holding any number of blocks\n
+ * On a host the buffer is usually a file mapped with mmap(), the decoder never copies it. Blocks failing their
+ * CRC or truncated are skipped and counted, decoding resumes at the next valid block.
+ *
+ * @code
+ * int fd = open("kiln.log", O_RDONLY);
+ * struct stat st;
+ * fstat(fd, &st);
+ * const uint8_t* data = (const uint8_t*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+ * MAX31856LogDecoder decoder(data, st.st_size);
+ * MAX31856LogRecord records[256];
+ * uint32_t n;
+ * while((n = decoder.read(records, 256)) > 0)
+ *      process(records, n);
+ * @endcode
+ */
+class MAX31856LogDecoder
+{
+
+public:
+    /** 
+    * @brief  Constructor of a decoder starting at the beginning of the buffer
+    * @param _data - Log contents, must stay valid while decoding
+    * @param _size - Length of the log in bytes
+    */
+    MAX31856LogDecoder(const uint8_t* _data, size_t _size);
+    
+    
+    /** 
+    * @brief  Decodes the next sample
+    * @param record - Receives the sample
+    * @return       \li 1 on success
+    *               \li 0 at the end of the log
+    */
+    bool next(MAX31856LogRecord& record);
+    
+    
+    /** 
+    * @brief  Decodes up to max_count samples in one call
+    * @param records - Receives the samples, must hold at least max_count records
+    * @param max_count - Maximum number of samples to decode
+    * @return number of samples decoded, 0 at the end of the log
+    */
+    uint32_t read(MAX31856LogRecord* records, uint32_t max_count);
+    
+    
+    /** @return number of valid blocks found so far */
+    uint32_t getBlockCount() const;
+    
+    
+    /** @return number of blocks skipped so far because of a bad CRC, a truncation or an inconsistent content */
+    uint32_t getCorruptCount() const;
+    
+    
+    /** 
+    * @brief  Computes the CRC-32 (IEEE 802.3) used by the blocks
+    * @param data - Bytes to check
+    * @param len - Number of bytes
+    * @return CRC of the bytes
+    */
+    static uint32_t crc32(const uint8_t* data, size_t len);
+    
+
+private:
+    /** @brief  Finds the next valid block from pos and prepares its decoding, returns 0 at the end of the log */
+    bool openBlock();
+    
+    
+    ///Log contents and its length
+    const uint8_t* data;
+    size_t size;
+    
+    ///Offset of the next block to look at
+    size_t pos = 0;
+    
+    ///Next sample byte and end of the samples of the open block
+    const uint8_t* sample_ptr = NULL;
+    const uint8_t* sample_end = NULL;
+    
+    ///Next run byte and end of the runs of the open block
+    const uint8_t* run_ptr = NULL;
+    const uint8_t* run_end = NULL;
+    
+    ///Samples left in the open block
+    uint32_t samples_left = 0;
+    
+    ///Fault status of the current run and samples left in it
+    uint8_t run_sr = 0;
+    uint32_t run_left = 0;
+    
+    ///Previous sample the changes apply to
+    int32_t prev_tc = 0;
+    int16_t prev_cj = 0;
+    uint32_t prev_timestamp = 0;
+    uint32_t prev_interval = 0;
+    
+    uint8_t cr0 = 0, cr1 = 0;
+    uint32_t block_count = 0;
+    uint32_t corrupt_count = 0;
+};
+
+#endif  /* MAX31856_LOG_h */
@@ -0,0 +1,163 @@
+/******************************************************************//**
+* @file lib_MAX31856_ring.h
+*
+* @version 1.0
+*
+* @brief Header file for MAX31856Ring class template
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_RING_h
+#define MAX31856_RING_h
+#include "lib_MAX31856_hal.h"
+
+
+/**
+ * @brief Fixed capacity, allocation free, lock free single producer / single consumer ring buffer\n
+ * One context (an interrupt or a high priority thread) calls push(), one other context calls pop() or popBatch().
+ * No lock is taken, each index is only written by one side and published with an atomic store.
+ * When the ring is full new elements are dropped and counted so the consumer can detect gaps.
+ *
+ * @code
+ * MAX31856Ring<MAX31856::Sample, 64> ring;
+ *
+ * void producer(void)     //high priority thread
+ * {
+ *      MAX31856::Sample sample;
+ *      while(true)
+ *          if(Thermocouple1.readSample(sample))
+ *              ring.push(sample);
+ * }
+ *
+ * void consumer(void)
+ * {
+ *      MAX31856::Sample batch[16];
+ *      uint32_t n = ring.popBatch(batch, 16);
+ * }
+ * @endcode
+ *
+ * @tparam T - Type of the elements, copied by value
+ * @tparam N - Capacity of the ring, must be a power of two
+ */
+template<typename T, uint32_t N>
+class MAX31856Ring
+{
+    static_assert(N >= 2 && (N & (N-1)) == 0, "MAX31856Ring capacity must be a power of two");
+
+public:
+    /** 
+    * @brief  Adds an element, producer side only
+    * @param item - Element copied into the ring
+    * @return       \li 1 on success   
+    *               \li 0 if the ring is full, the element is dropped and counted
+    */
+    bool push(const T& item)
+    {
+        uint32_t w = write_index;   //only modified by the producer
+        if(w - core_util_atomic_load_u32(&read_index) >= N) {
+            dropped++;
+            return false;
+        }
+        buf[w & (N-1)] = item;
+        core_util_atomic_store_u32(&write_index, w+1); //publish the element once it is fully copied
+        return true;
+    }
+    
+    
+    /** 
+    * @brief  Removes the oldest element, consumer side only
+    * @param item - Receives the element
+    * @return       \li 1 on success   
+    *               \li 0 if the ring is empty
+    */
+    bool pop(T& item)
+    {
+        return popBatch(&item, 1) == 1;
+    }
+    
+    
+    /** 
+    * @brief  Removes up to max_count of the oldest elements in one call, consumer side only
+    * @param items - Receives the elements, must hold at least max_count elements
+    * @param max_count - Maximum number of elements to remove
+    * @return number of elements removed
+    */
+    uint32_t popBatch(T* items, uint32_t max_count)
+    {
+        uint32_t r = read_index;    //only modified by the consumer
+        uint32_t available = core_util_atomic_load_u32(&write_index) - r;
+        uint32_t n = (available < max_count) ? available : max_count;
+        for(uint32_t i=0; i<n; i++) items[i] = buf[(r+i) & (N-1)];
+        core_util_atomic_store_u32(&read_index, r+n); //release the slots once they are copied
+        return n;
+    }
+    
+    
+    /** @return number of elements waiting in the ring, exact for the consumer, a lower bound of the free space for the producer */
+    uint32_t size() const
+    {
+        return core_util_atomic_load_u32(&write_index) - core_util_atomic_load_u32(&read_index);
+    }
+    
+    
+    /** @return capacity of the ring */
+    uint32_t capacity() const
+    {
+        return N;
+    }
+    
+    
+    /** @return number of elements dropped by push() because the ring was full */
+    uint32_t getDroppedCount() const
+    {
+        return core_util_atomic_load_u32(&dropped);
+    }
+    
+
+private:
+    /// Storage of the elements
+    T buf[N];
+    
+    /// Free running index of the next element to write, only written by the producer
+    volatile uint32_t write_index = 0;
+    
+    /// Free running index of the next element to read, only written by the consumer
+    volatile uint32_t read_index = 0;
+    
+    /// Number of elements dropped because the ring was full, only written by the producer
+    volatile uint32_t dropped = 0;
+};
+
+#endif  /* MAX31856_RING_h */
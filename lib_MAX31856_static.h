@@ -0,0 +1,100 @@
+/******************************************************************//**
+* @file lib_MAX31856_static.h
+*
+* @version 1.0
+*
+* @brief Header file for MAX31856T class template
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_STATIC_h
+#define MAX31856_STATIC_h
+#include "lib_MAX31856.h"
+
+
+/**
+ * @brief MAX31856 with its configuration fixed at compile time\n
+ * The thermocouple type, filter, averaging and conversion mode are template parameters: invalid values are rejected
+ * by the compiler, CR0, CR1 and the conversion times are constants, and the constructor writes the configuration in
+ * a single frame without any of the runtime parameter checks of the setters.
+ * All the functions of MAX31856 remain available to change the configuration later on.
+ *
+ * @code
+ * MAX31856T<CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4> Thermocouple1(spi, CHIPSELECT);
+ * wait_us(decltype(Thermocouple1)::CONVERSION_TIME_US);   //or poll isInitialized() while doing something else
+ * @endcode
+ *
+ * @tparam Type - CR1_TC_TYPE_B to CR1_TC_TYPE_T, CR1_TC_TYPE_VOLT_MODE_GAIN_8 or CR1_TC_TYPE_VOLT_MODE_GAIN_32
+ * @tparam Filter - CR0_FILTER_OUT_60Hz or CR0_FILTER_OUT_50Hz
+ * @tparam Avg - CR1_AVG_TC_SAMPLES_1 to CR1_AVG_TC_SAMPLES_16
+ * @tparam Mode - CR0_CONV_MODE_NORMALLY_OFF or CR0_CONV_MODE_NORMALLY_ON
+ */
+template<uint8_t Type=CR1_TC_TYPE_K, uint8_t Filter=CR0_FILTER_OUT_60Hz, uint8_t Avg=CR1_AVG_TC_SAMPLES_1, uint8_t Mode=CR0_CONV_MODE_NORMALLY_OFF>
+class MAX31856T : public MAX31856
+{
+    static_assert(Type <= CR1_TC_TYPE_T || Type == CR1_TC_TYPE_VOLT_MODE_GAIN_8 || Type == CR1_TC_TYPE_VOLT_MODE_GAIN_32, "MAX31856T: invalid thermocouple type, use one of CR1_TC_TYPE_*");
+    static_assert(Filter == CR0_FILTER_OUT_60Hz || Filter == CR0_FILTER_OUT_50Hz, "MAX31856T: invalid filter, use CR0_FILTER_OUT_60Hz or CR0_FILTER_OUT_50Hz");
+    static_assert(Avg == CR1_AVG_TC_SAMPLES_1 || Avg == CR1_AVG_TC_SAMPLES_2 || Avg == CR1_AVG_TC_SAMPLES_4 || Avg == CR1_AVG_TC_SAMPLES_8 || Avg == CR1_AVG_TC_SAMPLES_16, "MAX31856T: invalid averaging, use one of CR1_AVG_TC_SAMPLES_*");
+    static_assert(Mode == CR0_CONV_MODE_NORMALLY_OFF || Mode == CR0_CONV_MODE_NORMALLY_ON, "MAX31856T: invalid conversion mode, use CR0_CONV_MODE_NORMALLY_OFF or CR0_CONV_MODE_NORMALLY_ON");
+
+public:
+    /// Contents of CR0 written by the constructor
+    static constexpr uint8_t CR0 = Mode | Filter;
+    
+    /// Contents of CR1 written by the constructor
+    static constexpr uint8_t CR1 = Avg | Type;
+    
+    /// Number of samples averaged for one conversion
+    static constexpr uint32_t SAMPLES = 1 << (Avg >> 4);
+    
+    /// 1=the thermocouple is read in voltage mode
+    static constexpr bool VOLTAGE_MODE = (Type & CR1_TC_TYPE_VOLT_MODE_GAIN_8) != 0;
+    
+    /// Duration in microseconds of a 1-shot conversion or of the first conversion in normally on mode (same values as MAX31856::calculateDelayTime())
+    static constexpr uint32_t CONVERSION_TIME_US = 1000 * ((Filter == CR0_FILTER_OUT_60Hz) ? 82 + (SAMPLES-1)*3333/100 : 98 + (SAMPLES-1)*40);
+    
+    /// Duration in microseconds of the following conversions in normally on mode
+    static constexpr uint32_t CONTINUOUS_CONVERSION_TIME_US = 1000 * ((Filter == CR0_FILTER_OUT_60Hz) ? 82 + (SAMPLES-1)*1667/100 : 98 + (SAMPLES-1)*20);
+    
+    
+    /**
+    * @brief Constructor writing the compile time configuration to CR0 and CR1 in a single frame with MAX31856::begin(), returns without waiting
+    * @param _spi - Reference to SPI object
+    * @param _ncs - Chip Select for SPI comunications with the oject
+    */
+    MAX31856T(SPI& _spi, PinName _ncs) : MAX31856(_spi, _ncs, RegisterConfig{CR0, CR1}) {}
+};
+
+#endif  /* MAX31856_STATIC_h */
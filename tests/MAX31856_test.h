@@ -0,0 +1,84 @@
+/******************************************************************//**
+* @file MAX31856_test.h
+*
+* @version 1.0
+*
+* @brief Checks shared by the host tests of the MAX31856 library
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+
+#ifndef MAX31856_TEST_h
+#define MAX31856_TEST_h
+#include "lib_MAX31856.h"
+
+/**
+ * @brief Minimal checks shared by the host tests\n
+ * Each test is a function run by RUN_TEST() on a fresh simulated time, a failed CHECK() prints its location and
+ * the test program returns 1 if any check failed (TEST_RESULT()) so ctest reports it.
+ *
+ * @code
+ * static void testRead()
+ * {
+ *      SPI spi(0, 1, 2);
+ *      MAX31856Sim sim(10);
+ *      MAX31856 Thermocouple1(spi, 10);
+ *      CHECK(Thermocouple1.isInitialized());
+ * }
+ *
+ * int main(void)
+ * {
+ *      RUN_TEST(testRead);
+ *      return TEST_RESULT();
+ * }
+ * @endcode
+ */
+static int test_failures = 0;
+
+#define CHECK(cond)                                                                             \
+    do { if(!(cond)) { test_failures++;                                                         \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while(0)
+
+#define CHECK_NEAR(value, expected, tolerance)                                                  \
+    do { double v_ = (value), e_ = (expected);                                                  \
+        if(!(fabs(v_ - e_) <= (tolerance))) { test_failures++;                                  \
+        printf("%s:%d: %s = %f, expected %f\n", __FILE__, __LINE__, #value, v_, e_); } } while(0)
+
+#define RUN_TEST(test)                                                                          \
+    do { int before_ = test_failures; MAX31856Host::reset(); test();                           \
+        printf("%s %s\n", (test_failures == before_) ? "PASS" : "FAIL", #test); } while(0)
+
+#define TEST_RESULT()       (test_failures ? 1 : 0)
+
+#endif  /* MAX31856_TEST_h */
@@ -0,0 +1,253 @@
+/******************************************************************//**
+* @file test_MAX31856.cpp
+*
+* @version 1.0
+*
+* @brief Host tests of the reads, faults, 1-shot timing and initialization of the MAX31856 class
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+#define DRDY_PIN    11
+
+
+//*****************************************************************************
+static void testReadTC()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(250.5f, 24.25f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.isInitialized() == false);         //first conversion in progress
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(tc.isInitialized());
+    CHECK_NEAR(tc.readTC(), 250.5, 0.01);
+    CHECK_NEAR(tc.readCJ(), 24.25, 0.02);
+
+    sim.setTemperature(-100.0f, 30.0f);
+    MAX31856Host::advance(100000);
+    CHECK_NEAR(tc.readTC(), -100.0, 0.01);
+    CHECK_NEAR(tc.readCJ(), 30.0, 0.02);
+}
+
+
+//*****************************************************************************
+static void testReadTCSkipsBusDuringConversion()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    uint32_t frames = sim.getFrameCount();
+    tc.readTC();                                //next conversion not ready yet
+    CHECK(sim.getFrameCount() == frames);
+}
+
+
+//*****************************************************************************
+static void testOneShotTiming()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(100.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN);                   //normally off, begin() starts the first 1-shot conversion
+    CHECK(tc.isInitialized() == false);
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) & CR0_1_SHOT_MODE_ONE_CONVERSION);
+    uint32_t conversion_us = sim.conversionTime();
+    CHECK(conversion_us == 82000);              //60 Hz filter, 1 sample, data sheet table 3
+
+    MAX31856Host::advance(conversion_us - 1000);
+    CHECK(isnan(tc.readTC()));                  //not ready yet
+    CHECK(sim.getConversionCount() == 0);
+    MAX31856Host::advance(1000);
+    CHECK(sim.getConversionCount() == 1);
+    CHECK(tc.isInitialized());
+    CHECK((sim.getRegister(ADDRESS_CR0_READ) & CR0_1_SHOT_MODE_ONE_CONVERSION) == 0);  //self clearing
+    CHECK_NEAR(tc.readTC(), 100.0, 0.01);
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) & CR0_1_SHOT_MODE_ONE_CONVERSION);         //next conversion started by the read
+
+    tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_4);
+    CHECK(sim.conversionTime() == 82000 + 3 * 33330);
+}
+
+
+//*****************************************************************************
+static void testOpenCircuitFault()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(200.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    CHECK_NEAR(tc.readTC(), 200.0, 0.01);
+    CHECK(tc.checkFaultsThermocoupleConnection());
+
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    sim.setOpenCircuit(true);
+    sim.setTemperature(300.0f, 25.0f);
+    MAX31856Host::advance(300000);
+    CHECK_NEAR(tc.readTC(), 200.0, 0.01);       //result with a fault is not taken, the previous one is kept
+    MAX31856::FaultStatus status = tc.readFaultStatus();
+    CHECK(status.open);
+    CHECK(status.sr & SR_OPEN);
+    CHECK(tc.checkFaultsThermocoupleConnection() == false);
+
+    sim.setOpenCircuit(false);
+    status = tc.clearFault();
+    MAX31856Host::advance(300000);
+    CHECK(tc.readFaultStatus().any() == false);
+    CHECK_NEAR(tc.readTC(), 300.0, 0.01);
+}
+
+
+//*****************************************************************************
+static void testThresholdFaults()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(150.0f, 50.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setFaultThresholds(MASK_CJ_FAULT_THRESHOLD_HIGH, 40.0f));
+    CHECK(tc.setFaultThresholds(MASK_CJ_FAULT_THRESHOLD_LOW, 10.0f));
+    CHECK(tc.setFaultThresholds(0xFF, 10.0f) == false);
+    MAX31856Host::advance(200000);
+    CHECK(tc.checkFaultsColdJunctionThresholds() == 1);
+    CHECK(tc.readFaultStatus().cj_high);
+
+    sim.setTemperature(150.0f, 5.0f);
+    MAX31856Host::advance(200000);
+    CHECK(tc.checkFaultsColdJunctionThresholds() == 2);
+    CHECK(tc.readFaultStatus().cj_low);
+
+    sim.setTemperature(150.0f, 25.0f);
+    MAX31856Host::advance(200000);
+    CHECK(tc.readFaultStatus().any() == false);     //comparator mode follows the temperature
+    CHECK(tc.checkFaultsColdJunctionThresholds() == 0);
+}
+
+
+//*****************************************************************************
+static void testInitFailure()
+{
+    SPI spi(0, 1, 2);
+    MAX31856 tc(spi, TC_PIN);                   //no device answers, MISO reads 0xFF
+    CHECK(tc.isInitialized() == false);
+    CHECK(isnan(tc.readTC()));
+    CHECK(isnan(tc.readCJ()));
+    CHECK(tc.readTCRaw() == TC_RAW_INVALID);
+    CHECK(tc.readCJRaw() == CJ_RAW_INVALID);
+    MAX31856Host::advance(200000);
+    CHECK(tc.isInitialized() == false);
+    CHECK(isnan(tc.readTC()));
+
+    MAX31856Sim sim(TC_PIN + 1);                //a device on another chip select is not affected
+    MAX31856 other(spi, TC_PIN + 1);
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(other.isInitialized());
+}
+
+
+//*****************************************************************************
+static void writeBehindDriver(SPI& spi, uint8_t write_address, uint8_t val)
+{
+    DigitalOut cs(TC_PIN);                      //another master changing the device
+    spi.format(8, 3);
+    cs = 0;
+    spi.write(write_address);
+    spi.write(val);
+    cs = 1;
+}
+
+
+//*****************************************************************************
+static void testSyncRefreshesCache()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.verifyConfig());
+
+    writeBehindDriver(spi, ADDRESS_CR1_WRITE, CR1_AVG_TC_SAMPLES_4 | CR1_TC_TYPE_J);
+    CHECK(tc.verifyConfig() == false);
+    CHECK(tc.sync());
+    CHECK(tc.verifyConfig());
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_2));   //read-modify-write from the refreshed copy keeps type J
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_2 | CR1_TC_TYPE_J));
+
+    writeBehindDriver(spi, ADDRESS_CR1_WRITE, CR1_AVG_TC_SAMPLES_4 | CR1_TC_TYPE_K);
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_8));   //without sync() the stale copy is written back
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_8 | CR1_TC_TYPE_J));
+}
+
+
+//*****************************************************************************
+static void testWriteVerification()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim* sim = new MAX31856Sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    tc.resetSpiCounters();
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_2));
+    CHECK(tc.getSpiFrameCount() == 1);          //write only
+    tc.setWriteVerification(true);
+    tc.resetSpiCounters();
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_4));
+    CHECK(tc.getSpiFrameCount() == 2);          //write and read back
+    CHECK(sim->getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_4 | CR1_TC_TYPE_K));
+
+    delete sim;                                 //the device goes away, MISO floats high
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_8) == false);
+    CHECK(tc.setEmiFilterFreq(CR0_FILTER_OUT_50Hz) == false);
+    CHECK(tc.sync() == false);                  //cached copy kept
+    tc.setWriteVerification(false);
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_16));  //not noticed without verification
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testReadTC);
+    RUN_TEST(testReadTCSkipsBusDuringConversion);
+    RUN_TEST(testOneShotTiming);
+    RUN_TEST(testOpenCircuitFault);
+    RUN_TEST(testThresholdFaults);
+    RUN_TEST(testInitFailure);
+    RUN_TEST(testSyncRefreshesCache);
+    RUN_TEST(testWriteVerification);
+    return TEST_RESULT();
+}
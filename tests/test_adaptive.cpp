@@ -0,0 +1,139 @@
+/******************************************************************//**
+* @file test_adaptive.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the adaptive sampling between fast and averaged settings
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include <random>
+
+#define TC_PIN          10
+#define PHASE_MS        20000
+#define NOISE           0.25f       //°C rms of a single sample, divided by the square root of the averaging
+
+
+//*****************************************************************************
+struct PhaseResult {
+    double rate;                    //fresh results per second
+    double noise;                   //°C rms around the true temperature
+};
+
+static PhaseResult runPhase(MAX31856& tc, MAX31856Sim& sim, std::mt19937& gen, float start, float slope)
+{
+    std::normal_distribution<float> noise(0.0f, NOISE);
+    double sum = 0, sum2 = 0;
+    uint32_t count = 0;
+    uint32_t frames = tc.getSpiFrameCount();
+    for(int ms=0; ms<PHASE_MS; ms++) {
+        float truth = start + slope * ms / 1000.0f;
+        uint32_t samples = 1 << (sim.getRegister(ADDRESS_CR1_READ) >> 4);
+        sim.setTemperature(truth + noise(gen) / sqrtf(samples), 25.0f);
+        MAX31856Host::advance(1000);
+        if(ms % 10) continue;
+        uint32_t before = tc.getSpiFrameCount();
+        float value = tc.readTC();
+        if(tc.getSpiFrameCount() == before || isnan(value)) continue;   //no new result
+        double error = value - truth;
+        sum += error;
+        sum2 += error * error;
+        count++;
+    }
+    PhaseResult result;
+    result.rate = (tc.getSpiFrameCount() - frames) * 1000.0 / PHASE_MS;    //one frame per fresh result, adaptive switches excepted
+    double mean = sum / count;
+    result.noise = sqrt(sum2 / count - mean * mean);
+    return result;
+}
+
+
+//*****************************************************************************
+static void testAdaptiveSampling()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(25.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    MAX31856::AdaptiveConfig config = {CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON, CR1_AVG_TC_SAMPLES_16, CR0_CONV_MODE_NORMALLY_ON, 2.0f, 0.5f};
+    CHECK(tc.setAdaptiveSampling(&config));
+    std::mt19937 gen(1);
+
+    PhaseResult steady = runPhase(tc, sim, gen, 25.0f, 0.0f);
+    printf("steady 25 °C:    %.1f results/s, noise %.3f °C, %u switches\n", steady.rate, steady.noise, tc.getAdaptiveSwitchCount());
+    CHECK(tc.isAdaptiveFast() == false);
+    CHECK(tc.getAdaptiveSwitchCount() == 0);
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_16 | CR1_TC_TYPE_K));
+    CHECK(steady.noise < 0.1);
+
+    PhaseResult ramp = runPhase(tc, sim, gen, 25.0f, 10.0f);
+    printf("ramp 10 °C/s:    %.1f results/s, noise %.3f °C, %u switches\n", ramp.rate, ramp.noise, tc.getAdaptiveSwitchCount());
+    CHECK(tc.isAdaptiveFast());
+    CHECK(tc.getAdaptiveSwitchCount() == 1);
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_1 | CR1_TC_TYPE_K));
+    CHECK(ramp.rate > 3 * steady.rate);
+
+    PhaseResult back = runPhase(tc, sim, gen, 225.0f, 0.0f);
+    printf("steady 225 °C:   %.1f results/s, noise %.3f °C, %u switches\n", back.rate, back.noise, tc.getAdaptiveSwitchCount());
+    CHECK(tc.isAdaptiveFast() == false);
+    CHECK(tc.getAdaptiveSwitchCount() == 2);
+    CHECK(back.noise < 0.1);
+}
+
+
+//*****************************************************************************
+static void testInvalidSettings()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN);
+    MAX31856::AdaptiveConfig bad_fast = {0x77, 0x33, CR1_AVG_TC_SAMPLES_16, CR0_CONV_MODE_NORMALLY_ON, 2.0f, 0.5f};
+    MAX31856::AdaptiveConfig bad_slow = {CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON, 0x77, CR0_CONV_MODE_NORMALLY_ON, 2.0f, 0.5f};
+    MAX31856::AdaptiveConfig bad_rates = {CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON, CR1_AVG_TC_SAMPLES_16, CR0_CONV_MODE_NORMALLY_ON, 0.5f, 2.0f};
+    CHECK(tc.setAdaptiveSampling(&bad_fast) == false);
+    CHECK(tc.setAdaptiveSampling(&bad_slow) == false);
+    CHECK(tc.setAdaptiveSampling(&bad_rates) == false);
+    CHECK(tc.setAdaptiveSampling(NULL));           //turns adaptive sampling off
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testAdaptiveSampling);
+    RUN_TEST(testInvalidSettings);
+    return TEST_RESULT();
+}
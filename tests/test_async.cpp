@@ -0,0 +1,137 @@
+/******************************************************************//**
+* @file test_async.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the asynchronous result reads and of the CPU time of MAX31856Bus::pollAsync()
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_bus.h"
+
+#define TC_PIN          10
+#define CHANNELS        8
+#define RUN_TIME_US     1000000
+#define POLL_PERIOD_US  50
+
+static uint32_t done_calls = 0;
+static void transferDone() { done_calls++; }
+
+
+//*****************************************************************************
+static void testPollAsync()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(321.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.startConversion());
+    CHECK(tc.pollAsync() == false);                 //no result ready
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(tc.isReady());
+
+    done_calls = 0;
+    uint64_t start = MAX31856Host::now();
+    CHECK(tc.pollAsync(transferDone));
+    CHECK(MAX31856Host::now() == start);            //the CPU does not wait for the bytes
+    CHECK(sim.isSelected());
+    CHECK(tc.pollAsync() == false);                 //transfer pending
+    CHECK(tc.isTransferComplete() == false);
+    CHECK(tc.completeAsync() == false);
+
+    MAX31856Host::advance(100);                     //5 bytes at 1 MHz
+    CHECK(done_calls == 1);
+    CHECK(sim.isSelected() == false);               //released by the transfer event
+    CHECK(tc.isTransferComplete());
+    CHECK(tc.completeAsync());
+    CHECK_NEAR(tc.getLastTC(), 321.0, 0.01);
+}
+
+
+//*****************************************************************************
+static uint64_t runBus(bool async, uint32_t& samples)
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim* sims[CHANNELS];
+    MAX31856* devices[CHANNELS];
+    MAX31856Bus bus(2000);
+    for(int i=0; i<CHANNELS; i++) {
+        sims[i] = new MAX31856Sim(TC_PIN + i);
+        sims[i]->setTemperature(100.0f + i, 25.0f);
+        devices[i] = new MAX31856(spi, TC_PIN + i);
+        devices[i]->setConversionMode(CR0_CONV_MODE_NORMALLY_ON);
+        bus.addDevice(devices[i]);
+    }
+    bus.start();
+    uint64_t busy = 0;
+    samples = 0;
+    uint64_t end = MAX31856Host::now() + RUN_TIME_US;
+    while(MAX31856Host::now() < end) {
+        uint64_t start = MAX31856Host::now();       //simulated time only moves while the calling thread clocks bytes itself
+        samples += async ? bus.pollAsync() : bus.poll();
+        busy += MAX31856Host::now() - start;
+        MAX31856Host::advance(POLL_PERIOD_US);
+    }
+    for(int i=0; i<CHANNELS; i++) {
+        CHECK_NEAR(bus.getResult(i), 100.0 + i, 0.01);
+        delete devices[i];
+        delete sims[i];
+    }
+    return busy;
+}
+
+
+//*****************************************************************************
+static void testBusBusyTime()
+{
+    uint32_t sync_samples, async_samples;
+    uint64_t sync_busy = runBus(false, sync_samples);
+    MAX31856Host::reset();
+    uint64_t async_busy = runBus(true, async_samples);
+    printf("%d channels poll(): %u samples/s, %.1f us busy per sample\n", CHANNELS, sync_samples, (double)sync_busy / sync_samples);
+    printf("%d channels pollAsync(): %u samples/s, %.1f us busy per sample\n", CHANNELS, async_samples, (double)async_busy / async_samples);
+    CHECK(async_samples >= sync_samples - CHANNELS);
+    CHECK(sync_busy > 0);
+    CHECK(async_busy == 0);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testPollAsync);
+    RUN_TEST(testBusBusyTime);
+    return TEST_RESULT();
+}
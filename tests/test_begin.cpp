@@ -0,0 +1,178 @@
+/******************************************************************//**
+* @file test_begin.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the non-blocking initialization of MAX31856
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define FIRST_PIN       10
+#define DEVICES         32
+
+
+//*****************************************************************************
+static void testBootManyDevices()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim* sims[DEVICES];
+    MAX31856* devices[DEVICES];
+    for(int i=0; i<DEVICES; i++) {
+        sims[i] = new MAX31856Sim(FIRST_PIN + i);
+        sims[i]->setTemperature(20.0f + i, 25.0f);
+    }
+    uint64_t start = MAX31856Host::now();
+    for(int i=0; i<DEVICES; i++)
+        devices[i] = new MAX31856(spi, FIRST_PIN + i, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    uint32_t boot_us = (uint32_t)(MAX31856Host::now() - start);
+    printf("%d constructors: %u us, %u us of bus time, %u frames\n", DEVICES, boot_us, spi.getBusTime(), spi.getFrameCount());
+    CHECK(boot_us == spi.getBusTime());             //no wait besides the bytes clocked
+    CHECK(boot_us < 10000);
+    CHECK(spi.getFrameCount() == 3 * DEVICES);
+    CHECK(devices[0]->isInitialized() == false);    //first conversion in progress
+
+    while(!devices[DEVICES-1]->isInitialized()) MAX31856Host::advance(1000);
+    uint32_t ready_us = (uint32_t)(MAX31856Host::now() - start);
+    printf("all ready after %u us\n", ready_us);
+    CHECK(ready_us <= boot_us + sims[0]->conversionTime() + 1000);     //a single conversion time
+    for(int i=0; i<DEVICES; i++) {
+        CHECK(devices[i]->isInitialized());
+        CHECK_NEAR(devices[i]->readTC(), 20.0 + i, 0.01);
+        delete devices[i];
+        delete sims[i];
+    }
+}
+
+
+//*****************************************************************************
+static void testInvalidParameter()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(FIRST_PIN);
+    MAX31856 tc(spi, FIRST_PIN, 0x55);              //invalid thermocouple type
+    CHECK(tc.isInitialized() == false);
+    MAX31856Host::advance(200000);
+    CHECK(tc.isInitialized() == false);
+}
+
+
+//*****************************************************************************
+static void testBeginRecovers()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(FIRST_PIN);
+    sim.setTemperature(75.0f, 25.0f);
+    MAX31856 tc(spi, FIRST_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    CHECK(tc.isInitialized());
+
+    {
+        MAX31856 other(spi, FIRST_PIN, CR1_TC_TYPE_J);  //device reconfigured behind the object, like after a power cycle
+    }
+    CHECK(tc.verifyConfig() == false);
+    CHECK(tc.begin());                              //writes the cached configuration again
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == CR1_TC_TYPE_K);
+    CHECK(tc.isInitialized() == false);             //waits for the first conversion again without blocking
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(tc.isInitialized());
+    CHECK_NEAR(tc.readTC(), 75.0, 0.01);
+}
+
+
+//*****************************************************************************
+static void testBeginAfterFloatingBus()
+{
+    SPI spi(0, 1, 2);
+    MAX31856 tc(spi, FIRST_PIN, CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.isInitialized() == false);             //no device answers, MISO reads 0xFF
+    CHECK(tc.sync() == false);
+
+    MAX31856Sim sim(FIRST_PIN);                     //device connected later
+    sim.setTemperature(60.0f, 25.0f);
+    CHECK(tc.begin());                              //the floating bus read by sync() is not written back
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) == (CR0_CONV_MODE_NORMALLY_ON | CR0_FILTER_OUT_50Hz));
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_4 | CR1_TC_TYPE_J));
+    CHECK(sim.getRegister(ADDRESS_MASK_READ) == 0xFF);  //power on defaults
+    CHECK(sim.getRegister(ADDRESS_CJTO_READ) == 0x00);
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(tc.isInitialized());
+    CHECK_NEAR(tc.readTC(), 60.0, 0.01);
+}
+
+
+//*****************************************************************************
+static void testBeginStartsOneShot()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(FIRST_PIN);
+    sim.setTemperature(40.0f, 25.0f);
+    MAX31856 tc(spi, FIRST_PIN);                    //normally off
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) & CR0_1_SHOT_MODE_ONE_CONVERSION);
+    CHECK(tc.isInitialized() == false);             //first 1-shot conversion in progress
+    CHECK(isnan(tc.readTC()));
+    MAX31856Host::advance(sim.conversionTime());
+    CHECK(tc.isInitialized());
+    CHECK_NEAR(tc.readTC(), 40.0, 0.01);            //first call after the conversion time reads the result
+}
+
+
+//*****************************************************************************
+static void testIsInitializedIsConst()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(FIRST_PIN);
+    MAX31856 tc(spi, FIRST_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    const MAX31856& status = tc;
+    uint32_t frames = tc.getSpiFrameCount();
+    for(int i=0; i<10; i++) {
+        status.isInitialized();
+        MAX31856Host::advance(10000);
+    }
+    CHECK(tc.getSpiFrameCount() == frames);         //no bus access
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testBootManyDevices);
+    RUN_TEST(testInvalidParameter);
+    RUN_TEST(testBeginRecovers);
+    RUN_TEST(testBeginAfterFloatingBus);
+    RUN_TEST(testBeginStartsOneShot);
+    RUN_TEST(testIsInitializedIsConst);
+    return TEST_RESULT();
+}
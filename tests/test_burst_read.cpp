@@ -0,0 +1,193 @@
+/******************************************************************//**
+* @file test_burst_read.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the single frame reads of the thermocouple, cold junction and fault status registers
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+
+//*****************************************************************************
+static void testReadTCSingleFrame()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(123.5f, 22.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    spi.resetCounters();
+    uint32_t frames = sim.getFrameCount();
+    CHECK_NEAR(tc.readTC(), 123.5, 0.01);
+    CHECK(sim.getFrameCount() - frames == 1);   //LTCBH, LTCBM, LTCBL and SR by address auto-increment
+    CHECK(tc.getSpiFrameCount() == 1);
+    CHECK(tc.getSpiByteCount() == 5);           //address and 4 registers
+    CHECK(spi.getByteCount() == 5);
+}
+
+
+//*****************************************************************************
+static void testReadCJSingleFrame()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(123.5f, 22.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    CHECK_NEAR(tc.readCJ(), 22.0, 0.02);
+    CHECK(tc.getSpiFrameCount() == 1);          //CJTH and CJTL
+    CHECK(tc.getSpiByteCount() == 3);
+}
+
+
+//*****************************************************************************
+static void testThresholdFaultsFromSameFrame()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(150.0f, 50.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    tc.setFaultThresholds(MASK_CJ_FAULT_THRESHOLD_HIGH, 40.0f);
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    tc.readTC();
+    CHECK(tc.getSpiFrameCount() == 1);
+    CHECK(tc.getLastFaultStatus().cj_high);     //decoded from the SR byte of the same frame
+    CHECK(tc.getSpiFrameCount() == 1);
+}
+
+
+//*****************************************************************************
+static void testReadAllSingleFrame()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(123.5f, 22.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    MAX31856::Snapshot snapshot = tc.readAll();
+    CHECK_NEAR(snapshot.tc, 123.5, 0.01);
+    CHECK_NEAR(snapshot.cj, 22.0, 0.02);
+    CHECK(snapshot.sr == 0);
+    CHECK(tc.getSpiFrameCount() == 1);          //CJTH, CJTL, LTCBH, LTCBM, LTCBL and SR
+    CHECK(tc.getSpiByteCount() == 7);           //address and 6 registers
+    CHECK(tc.isResultReported());
+
+    tc.readAll();                               //next conversion not ready yet
+    CHECK(tc.getSpiFrameCount() == 1);
+    CHECK(tc.isResultReported() == false);
+}
+
+
+//*****************************************************************************
+static void testReadAllWaitsForOneShot()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(80.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN);                   //normally off, begin() starts the first 1-shot conversion
+    tc.resetSpiCounters();
+    MAX31856Host::advance(sim.conversionTime() - 1000);
+    CHECK(isnan(tc.readAll().tc));              //not ready yet, the bus is not used
+    CHECK(tc.getSpiFrameCount() == 0);
+    CHECK(sim.getConversionCount() == 0);
+
+    MAX31856Host::advance(1000);
+    MAX31856::Snapshot snapshot = tc.readAll();
+    CHECK_NEAR(snapshot.tc, 80.0, 0.01);
+    CHECK_NEAR(snapshot.cj, 25.0, 0.02);
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) & CR0_1_SHOT_MODE_ONE_CONVERSION);  //next conversion started by the read
+    CHECK_NEAR(tc.readAll().tc, 80.0, 0.01);    //last valid reading while the next one converts
+}
+
+
+//*****************************************************************************
+static void testReadAllDeadband()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(100.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setDeadband(1.0f));
+    MAX31856Host::advance(200000);
+    tc.readAll();
+    CHECK(tc.isResultReported());               //first result after setDeadband()
+    sim.setTemperature(100.5f, 25.0f);
+    MAX31856Host::advance(100000);
+    CHECK_NEAR(tc.readAll().tc, 100.5, 0.01);
+    CHECK(tc.isResultReported() == false);
+    CHECK(tc.getSuppressedCount() == 1);
+    CHECK(tc.getReportedCount() == 1);
+}
+
+
+//*****************************************************************************
+static void testReadsPerSecond()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    uint32_t conversions = sim.getConversionCount();
+    for(int i=0; i<100; i++) {
+        tc.readTC();
+        tc.readCJ();
+        MAX31856Host::advance(10000);
+    }
+    uint32_t results = sim.getConversionCount() - conversions;
+    CHECK(tc.getSpiFrameCount() <= results + 100);  //one frame per fresh result and per readCJ(), none while converting
+    printf("100 readTC()+readCJ() over %u conversions: %u frames, %u bytes\n", results, tc.getSpiFrameCount(), tc.getSpiByteCount());
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testReadTCSingleFrame);
+    RUN_TEST(testReadCJSingleFrame);
+    RUN_TEST(testThresholdFaultsFromSameFrame);
+    RUN_TEST(testReadAllSingleFrame);
+    RUN_TEST(testReadAllWaitsForOneShot);
+    RUN_TEST(testReadAllDeadband);
+    RUN_TEST(testReadsPerSecond);
+    return TEST_RESULT();
+}
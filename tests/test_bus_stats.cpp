@@ -0,0 +1,116 @@
+/******************************************************************//**
+* @file test_bus_stats.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the per-function SPI bus statistics of getBusStats(), built with MAX31856_BUS_STATS=1
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+#if !MAX31856_BUS_STATS
+#error "test_bus_stats is built with MAX31856_BUS_STATS=1"
+#endif
+
+
+//*****************************************************************************
+static void testPerMethodAccounting()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.getBusStats(MAX31856::BUS_CONFIG).calls >= 1);     //sync() and begin() of the constructor
+    MAX31856Host::advance(200000);
+    tc.resetBusStats();
+
+    tc.readTC();                                //address, LTCBH, LTCBM, LTCBL and SR at 1 MHz
+    tc.readTC();                                //conversion in progress, no bus access
+    MAX31856::BusStats stats = tc.getBusStats(MAX31856::BUS_READ_TC);
+    CHECK(stats.calls == 2);
+    CHECK(stats.frames == 1);
+    CHECK(stats.bytes == 5);
+    CHECK(stats.time_us == 40);
+
+    tc.readCJ();
+    stats = tc.getBusStats(MAX31856::BUS_READ_CJ);
+    CHECK(stats.calls == 1 && stats.frames == 1 && stats.bytes == 3 && stats.time_us == 24);
+
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_2));
+    stats = tc.getBusStats(MAX31856::BUS_SET_NUM_SAMPLES_AVG);
+    CHECK(stats.calls == 1 && stats.frames == 1 && stats.bytes == 2);
+    CHECK(tc.getBusStats(MAX31856::BUS_REGISTER_ACCESS).calls == 0);  //inner calls count for the outer function
+
+    MAX31856Host::advance(200000);
+    tc.readAll();
+    stats = tc.getBusStats(MAX31856::BUS_READ_ALL);
+    CHECK(stats.calls == 1 && stats.frames == 1 && stats.bytes == 7);
+
+    stats = tc.getBusStats(MAX31856::BUS_METHOD_COUNT);
+    CHECK(stats.calls == 0 && stats.frames == 0 && stats.bytes == 0 && stats.time_us == 0);
+    tc.resetBusStats();
+    CHECK(tc.getBusStats(MAX31856::BUS_READ_TC).calls == 0);
+}
+
+
+//*****************************************************************************
+static void testFrequencyChange()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(tc.setSpiFrequency(4000000));
+    CHECK(tc.setSpiFrequency(0) == false);
+    CHECK(tc.setSpiFrequency(SPI_MAX_HZ + 1) == false);
+    tc.resetBusStats();
+    MAX31856Host::advance(100000);
+    tc.readTC();                                //5 bytes at 4 MHz
+    CHECK(spi.getFrequency() == 4000000);
+    MAX31856::BusStats stats = tc.getBusStats(MAX31856::BUS_READ_TC);
+    CHECK(stats.bytes == 5);
+    CHECK(stats.time_us == 10);                 //40 us at 1 MHz
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testPerMethodAccounting);
+    RUN_TEST(testFrequencyChange);
+    return TEST_RESULT();
+}
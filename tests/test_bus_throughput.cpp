@@ -0,0 +1,116 @@
+/******************************************************************//**
+* @file test_bus_throughput.cpp
+*
+* @version 1.0
+*
+* @brief Host measurement of the samples per second of MAX31856Bus with several devices
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_bus.h"
+
+#define FIRST_PIN       20
+#define RUN_TIME_US     2000000
+#define POLL_PERIOD_US  500
+
+
+//*****************************************************************************
+static uint32_t runBus(uint8_t channels, uint32_t stagger_us)
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim* sims[MAX31856_BUS_MAX_DEVICES];
+    MAX31856* devices[MAX31856_BUS_MAX_DEVICES];
+    MAX31856Bus bus(stagger_us);
+    for(uint8_t i=0; i<channels; i++) {
+        sims[i] = new MAX31856Sim(FIRST_PIN + i);
+        sims[i]->setTemperature(100.0f + i, 25.0f);
+        devices[i] = new MAX31856(spi, FIRST_PIN + i);
+        CHECK(bus.addDevice(devices[i]));
+    }
+    bus.start();
+    uint32_t samples = 0;
+    uint64_t start = MAX31856Host::now();
+    while(MAX31856Host::now() - start < RUN_TIME_US) {
+        samples += bus.poll();
+        MAX31856Host::advance(POLL_PERIOD_US);
+    }
+    for(uint8_t i=0; i<channels; i++) {
+        CHECK_NEAR(bus.getResult(i), 100.0 + i, 0.01);
+        CHECK(bus.getSampleCount(i) > 0);
+        delete devices[i];
+        delete sims[i];
+    }
+    return samples * 1000000ULL / RUN_TIME_US;
+}
+
+
+//*****************************************************************************
+static void testSingleDeviceBaseline()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(FIRST_PIN);
+    MAX31856 tc(spi, FIRST_PIN);
+    uint32_t samples = 0;
+    uint64_t start = MAX31856Host::now();
+    while(MAX31856Host::now() - start < RUN_TIME_US) {     //every readTC() waits for its own 1-shot conversion
+        tc.readTC();
+        MAX31856Host::advance(sim.conversionTime());
+        if(!isnan(tc.readTC())) samples++;
+    }
+    printf("blocking readTC(): %u samples/s in total, the devices are read one after the other\n", (uint32_t)(samples * 1000000ULL / RUN_TIME_US));
+    CHECK(samples > 0);
+}
+
+
+//*****************************************************************************
+static void testScaling()
+{
+    const uint32_t per_channel = 1000000 / 82000;                  //1-shot conversion time, 60 Hz filter, 1 sample
+    const uint8_t channels[] = {1, 2, 4, 8, 16, 32};
+    for(uint8_t n : channels) {
+        uint32_t rate = runBus(n, 2000);
+        printf("%2u devices: %4u samples/s\n", n, rate);
+        CHECK(rate * 100 >= n * per_channel * 85);                 //within 15 % of n channels converting back to back
+    }
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testSingleDeviceBaseline);
+    RUN_TEST(testScaling);
+    return TEST_RESULT();
+}
@@ -0,0 +1,130 @@
+/******************************************************************//**
+* @file test_commit.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the registers and bytes written by beginConfig() and commit()
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+
+//*****************************************************************************
+static void testConstructorFrames()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.getSpiFrameCount() == 3);                          //sync read, configuration write, verify read
+    CHECK(sim.getFrameCount() == 3);
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) == (CR0_CONV_MODE_NORMALLY_ON | CR0_FILTER_OUT_50Hz));
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_4 | CR1_TC_TYPE_J));
+}
+
+
+//*****************************************************************************
+static void testCommitWritesStagedRegisters()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN);
+    uint8_t before[16];
+    for(int i=0; i<16; i++) before[i] = sim.getRegister(i);
+
+    tc.resetSpiCounters();
+    tc.beginConfig();
+    CHECK(tc.setThermocoupleType(CR1_TC_TYPE_T));
+    CHECK(tc.setEmiFilterFreq(CR0_FILTER_OUT_50Hz));
+    CHECK(tc.setNumSamplesAvg(CR1_AVG_TC_SAMPLES_8));
+    CHECK(tc.getSpiFrameCount() == 0);                          //staged only
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == before[ADDRESS_CR1_READ]);
+
+    CHECK(tc.commit());
+    CHECK(tc.getSpiFrameCount() == 2);                          //one write frame, one verify frame
+    CHECK(tc.getSpiByteCount() == (1 + 2) + (1 + CONFIG_REGISTER_COUNT));   //CR0 and CR1, then CR0 to CJTO
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) == CR0_FILTER_OUT_50Hz);
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == (CR1_AVG_TC_SAMPLES_8 | CR1_TC_TYPE_T));
+    for(int i=ADDRESS_MASK_READ; i<CONFIG_REGISTER_COUNT; i++)
+        CHECK(sim.getRegister(i) == before[i]);                 //registers after the last staged one are untouched
+}
+
+
+//*****************************************************************************
+static void testCommitUpToLastStagedRegister()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN);
+    tc.resetSpiCounters();
+    tc.beginConfig();
+    CHECK(tc.setFaultThresholds(MASK_CJ_FAULT_THRESHOLD_HIGH, 60.0f));
+    CHECK(tc.commit(false));
+    CHECK(tc.getSpiFrameCount() == 1);                          //no verify frame
+    CHECK(tc.getSpiByteCount() == 1 + ADDRESS_CJHF_READ + 1);   //CR0 to CJHF
+    CHECK(sim.getRegister(ADDRESS_CJHF_READ) == 60);
+
+    tc.resetSpiCounters();
+    tc.beginConfig();
+    CHECK(tc.commit(false));                                    //nothing staged
+    CHECK(tc.getSpiFrameCount() == 0);
+}
+
+
+//*****************************************************************************
+static void testCommitDetectsMismatch()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN);
+    tc.beginConfig();
+    CHECK(tc.setConversionMode(CR0_CONV_MODE_NORMALLY_ON));
+    CHECK(tc.commit());
+    CHECK(tc.verifyConfig());
+    MAX31856 other(spi, TC_PIN, CR1_TC_TYPE_S);                 //changed behind the cached copy
+    CHECK(tc.verifyConfig() == false);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testConstructorFrames);
+    RUN_TEST(testCommitWritesStagedRegisters);
+    RUN_TEST(testCommitUpToLastStagedRegister);
+    RUN_TEST(testCommitDetectsMismatch);
+    return TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+/******************************************************************//**
+* @file test_deadband.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the deadband: threshold, heartbeat, NAN transitions and counters
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+
+//*****************************************************************************
+static bool nextResult(MAX31856& tc, MAX31856Sim& sim, float temperature, float& value)
+{
+    sim.setTemperature(temperature, 25.0f);
+    MAX31856Host::advance(100000);              //at least one new conversion
+    return tc.readTCChanged(value);
+}
+
+
+//*****************************************************************************
+static void testThreshold()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setDeadband(0.5f));
+    float value;
+    CHECK(nextResult(tc, sim, 100.0f, value));          //first result after setDeadband()
+    CHECK(nextResult(tc, sim, 100.25f, value) == false);
+    CHECK_NEAR(value, 100.25, 0.01);                    //suppressed results are still returned by readTC()
+    CHECK(nextResult(tc, sim, 100.5f, value) == false); //not more than the threshold
+    CHECK(nextResult(tc, sim, 100.75f, value));
+    CHECK(nextResult(tc, sim, 100.5f, value) == false); //compared with the last reported result
+    CHECK(tc.readTCChanged(value) == false);            //no new result
+    CHECK(tc.getReportedCount() == 2);
+    CHECK(tc.getSuppressedCount() == 3);
+
+    CHECK(tc.setDeadband(-1.0f) == false);
+    CHECK(tc.setDeadband(NAN) == false);
+    CHECK(nextResult(tc, sim, 100.5f, value));          //deadband off, every result is reported
+    CHECK(tc.setDeadband(0.5f));
+    CHECK(tc.getReportedCount() == 0 && tc.getSuppressedCount() == 0);
+    tc.clearDeadband();
+    CHECK(nextResult(tc, sim, 100.5f, value));
+}
+
+
+//*****************************************************************************
+static void testHeartbeat()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setDeadband(1.0f, 500000));
+    float value;
+    CHECK(nextResult(tc, sim, 50.0f, value));
+    for(int i=0; i<4; i++)
+        CHECK(nextResult(tc, sim, 50.0f, value) == false);
+    CHECK(nextResult(tc, sim, 50.0f, value));           //500 ms without a report
+    CHECK(nextResult(tc, sim, 50.0f, value) == false);  //heartbeat restarted
+    CHECK(tc.getReportedCount() == 2);
+    CHECK(tc.getSuppressedCount() == 5);
+}
+
+
+//*****************************************************************************
+static void testInvalidTransitions()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    const MAX31856Thermocouple* k = MAX31856Linearization::getThermocouple(CR1_TC_TYPE_K);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_VOLT_MODE_GAIN_8, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    tc.setSoftwareLinearization(k);
+    CHECK(tc.setDeadband(5.0f));
+    sim.setTemperature(25.0f, 25.0f);
+    float valid_volts = (MAX31856Linearization::temperatureToMillivolts(k, 400.0f) - MAX31856Linearization::temperatureToMillivolts(k, 25.0f)) / 1000.0f;
+    float value;
+
+    sim.setVoltage(valid_volts);
+    MAX31856Host::advance(200000);
+    CHECK(tc.readTCChanged(value));
+    CHECK_NEAR(value, 400.0, 0.1);
+
+    sim.setVoltage(0.1f);                               //100 mV, above the range of type K
+    MAX31856Host::advance(100000);
+    CHECK(tc.readTCChanged(value));                     //turning NAN is reported
+    CHECK(isnan(value));
+    MAX31856Host::advance(100000);
+    CHECK(tc.readTCChanged(value) == false);            //still NAN
+
+    sim.setVoltage(valid_volts);
+    MAX31856Host::advance(100000);
+    CHECK(tc.readTCChanged(value));                     //valid again, even within the threshold of the last valid report
+    CHECK_NEAR(value, 400.0, 0.1);
+    MAX31856Host::advance(100000);
+    CHECK(tc.readTCChanged(value) == false);
+    CHECK(tc.getReportedCount() == 3);
+    CHECK(tc.getSuppressedCount() == 2);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testThreshold);
+    RUN_TEST(testHeartbeat);
+    RUN_TEST(testInvalidTransitions);
+    return TEST_RESULT();
+}
@@ -0,0 +1,167 @@
+/******************************************************************//**
+* @file test_fault_log.cpp
+*
+* @version 1.0
+*
+* @brief Host test of processFaultLog() with a recording sink: delivery, rate limit and merging of repeated faults
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include <string>
+#include <vector>
+
+#define TC_PIN          10
+#define INTERVAL_US     1000000
+
+static std::vector<std::string> messages;
+
+
+//*****************************************************************************
+static void recordFault(const char* message)
+{
+    messages.push_back(message);
+}
+
+
+//*****************************************************************************
+static bool logged(size_t index, const char* text)
+{
+    return index < messages.size() && messages[index].find(text) != std::string::npos;
+}
+
+
+//*****************************************************************************
+static void testSinkDelivery()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(100.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    messages.clear();
+    tc.attachFaultLog(recordFault, INTERVAL_US);
+    MAX31856Host::advance(200000);
+    CHECK_NEAR(tc.readTC(), 100.0, 0.01);
+    CHECK(tc.processFaultLog() == 0);           //nothing recorded
+    CHECK(messages.empty());
+
+    sim.setOpenCircuit(true);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(messages.empty());                    //recorded only, never reported from the reading function
+    CHECK(tc.processFaultLog() == SR_OPEN);
+    CHECK(messages.size() == 1);
+    CHECK(logged(0, "open"));
+    CHECK(tc.processFaultLog() == 0);           //reported once
+    CHECK(messages.size() == 1);
+}
+
+
+//*****************************************************************************
+static void testRateLimitAndMerge()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(100.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    messages.clear();
+    tc.attachFaultLog(recordFault, INTERVAL_US);
+    sim.setOpenCircuit(true);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == SR_OPEN);     //the first report is not delayed
+    CHECK(messages.size() == 1);
+
+    for(int i=0; i<4; i++) {                    //the same fault on every result of the next 800 ms
+        MAX31856Host::advance(200000);
+        tc.readTC();
+        CHECK(tc.processFaultLog() == 0);       //rate limited
+    }
+    sim.setOverUnderVoltage(true);
+    MAX31856Host::advance(100000);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == 0);
+    CHECK(messages.size() == 1);
+
+    MAX31856Host::advance(100000);              //1 s after the first report
+    CHECK(tc.processFaultLog() == (SR_OVUV | SR_OPEN));
+    CHECK(messages.size() == 3);                //one message per fault, however often it was seen
+    CHECK(logged(1, "over or under voltage"));
+    CHECK(logged(2, "open"));
+
+    sim.setOpenCircuit(false);
+    sim.setOverUnderVoltage(false);
+    MAX31856Host::advance(INTERVAL_US);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == 0);           //faults cleared, nothing pending after the interval either
+    CHECK(messages.size() == 3);
+}
+
+
+//*****************************************************************************
+static void testDetachSink()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    messages.clear();
+    tc.attachFaultLog(recordFault, 0);
+    sim.setOpenCircuit(true);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == SR_OPEN);
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == SR_OPEN);     //no minimum interval
+    CHECK(messages.size() == 2);
+
+    tc.attachFaultLog(Callback<void(const char*)>(), 0);   //back to printf()
+    MAX31856Host::advance(200000);
+    tc.readTC();
+    CHECK(tc.processFaultLog() == SR_OPEN);
+    CHECK(messages.size() == 2);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testSinkDelivery);
+    RUN_TEST(testRateLimitAndMerge);
+    RUN_TEST(testDetachSink);
+    return TEST_RESULT();
+}
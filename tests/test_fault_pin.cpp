@@ -0,0 +1,128 @@
+/******************************************************************//**
+* @file test_fault_pin.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the FAULT pin: status register skipped on clean reads, latched faults and clearFault()
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+#define FAULT_PIN   12
+
+static int fault_edges = 0;
+
+
+//*****************************************************************************
+static void faultFell()
+{
+    fault_edges++;
+}
+
+
+//*****************************************************************************
+static void testCleanReadsSkipStatus()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN, NC, FAULT_PIN);
+    sim.setTemperature(120.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.attachFault(FAULT_PIN));
+    CHECK((sim.getRegister(ADDRESS_MASK_READ) & MASK_OPEN_CIRCUIT_FAULT) == 0);    //open circuit unmasked, drives FAULT
+    MAX31856Host::advance(200000);
+    tc.resetSpiCounters();
+    CHECK_NEAR(tc.readTC(), 120.0, 0.01);
+    CHECK(tc.getSpiFrameCount() == 1);
+    CHECK(tc.getSpiByteCount() == 4);           //address, LTCBH, LTCBM and LTCBL, SR skipped while FAULT is high
+    CHECK(tc.isFaultLatched() == false);
+}
+
+
+//*****************************************************************************
+static void testFaultLatchesAndClears()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN, NC, FAULT_PIN);
+    sim.setTemperature(120.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    fault_edges = 0;
+    CHECK(tc.attachFault(FAULT_PIN, faultFell));
+    MAX31856Host::advance(300000);
+    CHECK_NEAR(tc.readTC(), 120.0, 0.01);
+
+    sim.setOpenCircuit(true);                   //the next conversion reports the open thermocouple and pulls FAULT low
+    sim.setTemperature(300.0f, 25.0f);
+    MAX31856Host::advance(300000);
+    CHECK(fault_edges == 1);
+    CHECK(tc.isFaultLatched());
+    tc.resetSpiCounters();
+    CHECK_NEAR(tc.readTC(), 120.0, 0.01);       //result with a fault is not taken
+    CHECK(tc.getSpiByteCount() == 5);           //SR back in the frame
+    CHECK(tc.getLastFaultStatus().open);
+
+    sim.setOpenCircuit(false);
+    MAX31856Host::advance(300000);              //FAULT back high, the latch holds until clearFault()
+    CHECK(tc.isFaultLatched());
+    tc.clearFault();
+    CHECK(tc.isFaultLatched() == false);
+    MAX31856Host::advance(300000);
+    tc.resetSpiCounters();
+    CHECK_NEAR(tc.readTC(), 300.0, 0.01);
+    CHECK(tc.getSpiByteCount() == 4);           //SR skipped again
+    CHECK(fault_edges == 1);
+}
+
+
+//*****************************************************************************
+static void testAttachFailsWithoutDevice()
+{
+    SPI spi(0, 1, 2);
+    MAX31856 tc(spi, TC_PIN);                   //no device answers
+    tc.setWriteVerification(true);
+    CHECK(tc.attachFault(FAULT_PIN) == false);  //MASK read back fails, the pin is not used
+    CHECK(tc.isFaultLatched() == false);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testCleanReadsSkipStatus);
+    RUN_TEST(testFaultLatchesAndClears);
+    RUN_TEST(testAttachFailsWithoutDevice);
+    return TEST_RESULT();
+}
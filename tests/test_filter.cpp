@@ -0,0 +1,155 @@
+/******************************************************************//**
+* @file test_filter.cpp
+*
+* @version 1.0
+*
+* @brief Host test and timing of the fixed point filters
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_filter.h"
+#include <chrono>
+#include <random>
+
+#define READINGS        (1 << 20)
+#define REPEAT          20
+#define TRUE_RAW        3200        //25 °C in 1/128 °C
+#define SPIKE_PERIOD    500
+#define SPIKE_RAW       2000        //15.6 °C
+
+static int32_t input[READINGS], output[READINGS];
+
+
+//*****************************************************************************
+struct Unfiltered {
+    int32_t update(int32_t raw) { return raw; }
+    void reset() {}
+};
+
+template<typename Filter>
+static double measure(const char* name, Filter& filter)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(int r=0; r<REPEAT; r++) {
+        filter.reset();
+        for(int i=0; i<READINGS; i++) output[i] = filter.update(input[i]);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)REPEAT * READINGS);
+    double sum2 = 0;
+    for(int i=1000; i<READINGS; i++) {      //settled
+        double error = MAX31856::tcRawToCelsius(output[i] - TRUE_RAW);
+        sum2 += error * error;
+    }
+    double rms = sqrt(sum2 / (READINGS - 1000));
+    printf("%-22s %6.1f ns/sample   rms error %.3f °C\n", name, ns, rms);
+    return rms;
+}
+
+
+//*****************************************************************************
+static void testNoiseAndSpikes()
+{
+    std::mt19937 gen(3);
+    std::normal_distribution<float> noise(0.0f, 0.25f * 128);
+    for(int i=0; i<READINGS; i++) {
+        input[i] = TRUE_RAW + (int32_t)lrintf(noise(gen));
+        if(i % SPIKE_PERIOD == 0) input[i] += SPIKE_RAW;
+    }
+    Unfiltered none;
+    MAX31856Median<5> median;
+    MAX31856EMA<4> ema;
+    MAX31856Kalman<1, 1024> kalman;
+    MAX31856FilterPipeline<MAX31856Median<5>, MAX31856EMA<4>, MAX31856Kalman<1, 1024> > chain;
+    double rms_none = measure("unfiltered", none);
+    CHECK(measure("median5", median) < 0.15);
+    CHECK(measure("ema4", ema) < 0.15);
+    CHECK(measure("kalman", kalman) < 0.1);
+    CHECK(measure("median5+ema4+kalman", chain) < 0.05);
+    CHECK(rms_none > 0.5);
+}
+
+
+//*****************************************************************************
+static void testStages()
+{
+    MAX31856Median<3> median;
+    const int32_t in[] = {5, 1, 9, -4, 100, 2};
+    const int32_t expected[] = {5, 5, 5, 1, 9, 2};     //upper median of the readings received so far, then of the last 3
+    for(int i=0; i<6; i++) CHECK(median.update(in[i]) == expected[i]);
+    CHECK(median.update(TC_RAW_INVALID) == TC_RAW_INVALID);
+
+    MAX31856EMA<2> ema;
+    for(int i=0; i<40; i++) ema.update(-1000);
+    CHECK(ema.update(-1000) == -1000);                  //negative values settle exactly
+    CHECK(ema.update(TC_RAW_INVALID) == TC_RAW_INVALID);
+
+    MAX31856Kalman<> kalman;
+    for(int i=0; i<2000; i++) kalman.update(-5000);
+    CHECK(kalman.update(-5000) == -5000);
+    CHECK(kalman.update(TC_RAW_INVALID) == TC_RAW_INVALID);
+}
+
+
+//*****************************************************************************
+static void testKalmanLimits()
+{
+    MAX31856Kalman<MAX31856_KALMAN_MAX_VARIANCE, MAX31856_KALMAN_MAX_VARIANCE> kalman;
+    int32_t low = INT32_MAX, high = INT32_MIN;
+    for(int i=0; i<10000; i++) {
+        int32_t y = kalman.update((i & 1) ? 1010 : 1000);
+        if(i < 10) continue;
+        if(y < low) low = y;
+        if(y > high) high = y;
+    }
+    printf("variances at MAX31856_KALMAN_MAX_VARIANCE, input 1000/1010: output %d..%d\n", low, high);
+    CHECK(low >= 1000 && high <= 1010);                 //no wrap around of the variance arithmetic
+
+    MAX31856Kalman<> settable;
+    CHECK(settable.setNoise(0, 0) == false);            //would divide by zero
+    CHECK(settable.setNoise(MAX31856_KALMAN_MAX_VARIANCE + 1, 1) == false);
+    CHECK(settable.setNoise(1, MAX31856_KALMAN_MAX_VARIANCE + 1) == false);
+    CHECK(settable.setNoise(4, 2048));
+    CHECK(settable.setNoise(0, 1));
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testStages);
+    RUN_TEST(testKalmanLimits);
+    RUN_TEST(testNoiseAndSpikes);
+    return TEST_RESULT();
+}
@@ -0,0 +1,129 @@
+/******************************************************************//**
+* @file test_instrumentation.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the counters and latency histograms of getInstrumentation(), built with MAX31856_INSTRUMENTATION=1
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+#if !MAX31856_INSTRUMENTATION
+#error "test_instrumentation is built with MAX31856_INSTRUMENTATION=1"
+#endif
+
+
+//*****************************************************************************
+static void testReadCounters()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(150.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_R_LESS_5k));
+    tc.readTC();                                //first conversion in progress
+    MAX31856Host::advance(300000);
+    tc.readTC();
+    tc.readTC();                                //next conversion not ready yet
+    MAX31856::Instrumentation counters = tc.getInstrumentation();
+    CHECK(counters.fresh_reads == 1);
+    CHECK(counters.stale_reads == 2);
+    CHECK(counters.fault_skips == 0);
+
+    sim.setOpenCircuit(true);
+    MAX31856Host::advance(300000);
+    CHECK_NEAR(tc.readTC(), 150.0, 0.01);       //previous result kept
+    counters = tc.getInstrumentation();
+    CHECK(counters.fault_skips == 1);
+    CHECK(counters.fresh_reads == 1);
+
+    tc.resetInstrumentation();
+    counters = tc.getInstrumentation();
+    CHECK(counters.fresh_reads == 0 && counters.stale_reads == 0 && counters.fault_skips == 0);
+    CHECK(counters.tc_latency[0] == 0);
+}
+
+
+//*****************************************************************************
+static void testInitFailures()
+{
+    SPI spi(0, 1, 2);
+    MAX31856 tc(spi, TC_PIN);                   //no device answers
+    CHECK(isnan(tc.readTC()));
+    CHECK(isnan(tc.readCJ()));
+    MAX31856::Instrumentation counters = tc.getInstrumentation();
+    CHECK(counters.init_failures == 2);
+    CHECK(counters.fresh_reads == 0 && counters.stale_reads == 0);
+}
+
+
+//*****************************************************************************
+static void testLatencyBuckets()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(200000);
+    tc.resetInstrumentation();
+
+    tc.readTC();                                //5 bytes at 1 MHz: 40 us, bucket 20 to 50 us
+    tc.readTC();                                //no bus access: 0 us, first bucket
+    tc.readCJ();                                //3 bytes: 24 us
+    MAX31856::Instrumentation counters = tc.getInstrumentation();
+    CHECK(counters.tc_latency[0] == 1);
+    CHECK(counters.tc_latency[2] == 1);
+    CHECK(counters.cj_latency[2] == 1);
+
+    CHECK(tc.setSpiFrequency(250000));          //5 bytes at 250 kHz: 160 us, bucket 100 to 200 us
+    MAX31856Host::advance(100000);
+    tc.readTC();
+    counters = tc.getInstrumentation();
+    CHECK(counters.tc_latency[4] == 1);
+    uint32_t total = 0;
+    for(int i=0; i<MAX31856_LATENCY_BUCKETS; i++) total += counters.tc_latency[i];
+    CHECK(total == 3);                          //one bucket per call
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testReadCounters);
+    RUN_TEST(testInitFailures);
+    RUN_TEST(testLatencyBuckets);
+    return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+/******************************************************************//**
+* @file test_linear.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the software linearization and comparison of compensate() and compensateBatch()
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include <chrono>
+
+#define TC_PIN          10
+#define BATCH_SIZE      65536
+#define BATCH_REPEAT    20
+
+static const float range_min[8] = {250, -200, -210, -200, -200, -50, -50, -200};   //B, E, J, K, N, R, S, T in °C
+static const float range_max[8] = {1820, 1000, 1200, 1372, 1300, 1768, 1768, 400};
+static float mv[BATCH_SIZE], cj[BATCH_SIZE], scalar[BATCH_SIZE], batch[BATCH_SIZE];
+
+
+//*****************************************************************************
+static void testRoundTrip()
+{
+    for(uint8_t type=CR1_TC_TYPE_B; type<=CR1_TC_TYPE_T; type++) {
+        const MAX31856Thermocouple* tc = MAX31856Linearization::getThermocouple(type);
+        CHECK(tc != NULL);
+        float worst = 0.0f;
+        for(float t=range_min[type]; t<=range_max[type]; t+=0.25f) {
+            float t2 = MAX31856Linearization::millivoltsToTemperature(tc, MAX31856Linearization::temperatureToMillivolts(tc, t));
+            CHECK(!isnan(t2));
+            worst = fmaxf(worst, fabsf(t2 - t));
+        }
+        printf("type %u round trip error %.4f °C\n", type, worst);
+        CHECK(worst < 0.08f);
+    }
+    CHECK(MAX31856Linearization::getThermocouple(CR1_TC_TYPE_VOLT_MODE_GAIN_8) == NULL);
+    CHECK(isnan(MAX31856Linearization::millivoltsToTemperature(MAX31856Linearization::getThermocouple(CR1_TC_TYPE_K), 100.0f)));
+}
+
+
+//*****************************************************************************
+static void testNistReference()
+{
+    //NIST ITS-90 table values in mV
+    const MAX31856Thermocouple* k = MAX31856Linearization::getThermocouple(CR1_TC_TYPE_K);
+    CHECK_NEAR(MAX31856Linearization::temperatureToMillivolts(k, 500.0f), 20.644, 0.002);
+    CHECK_NEAR(MAX31856Linearization::temperatureToMillivolts(k, -100.0f), -3.554, 0.002);
+    const MAX31856Thermocouple* j = MAX31856Linearization::getThermocouple(CR1_TC_TYPE_J);
+    CHECK_NEAR(MAX31856Linearization::temperatureToMillivolts(j, 300.0f), 16.327, 0.002);
+    const MAX31856Thermocouple* t = MAX31856Linearization::getThermocouple(CR1_TC_TYPE_T);
+    CHECK_NEAR(MAX31856Linearization::temperatureToMillivolts(t, 100.0f), 4.279, 0.002);
+    CHECK_NEAR(MAX31856Linearization::compensate(k, 20.644f - 1.000f, 25.0f), 500.0, 0.1);    //1.000 mV at 25 °C
+}
+
+
+//*****************************************************************************
+static void testVoltageMode()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    const MAX31856Thermocouple* k = MAX31856Linearization::getThermocouple(CR1_TC_TYPE_K);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_VOLT_MODE_GAIN_8, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    tc.setSoftwareLinearization(k);
+    sim.setTemperature(25.0f, 25.0f);
+    sim.setVoltage((MAX31856Linearization::temperatureToMillivolts(k, 400.0f) - MAX31856Linearization::temperatureToMillivolts(k, 25.0f)) / 1000.0f);
+    MAX31856Host::advance(200000);
+    CHECK_NEAR(tc.readTC(), 400.0, 0.1);
+}
+
+
+//*****************************************************************************
+static void testBatchMatchesScalar()
+{
+    for(uint8_t type=CR1_TC_TYPE_B; type<=CR1_TC_TYPE_T; type++) {
+        const MAX31856Thermocouple* tc = MAX31856Linearization::getThermocouple(type);
+        float mv_min = MAX31856Linearization::temperatureToMillivolts(tc, range_min[type]);
+        float mv_max = MAX31856Linearization::temperatureToMillivolts(tc, range_max[type]);
+        for(uint32_t i=0; i<BATCH_SIZE; i++) {
+            mv[i] = mv_min + (mv_max - mv_min) * i / BATCH_SIZE;
+            cj[i] = 20.0f + 5.0f * sinf(i * 1e-3f);
+        }
+        cj[7] = -300.0f;                                            //outside every range
+        mv[9] = 1000.0f;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for(int r=0; r<BATCH_REPEAT; r++)
+            for(uint32_t i=0; i<BATCH_SIZE; i++) scalar[i] = MAX31856Linearization::compensate(tc, mv[i], cj[i]);
+        auto t1 = std::chrono::steady_clock::now();
+        for(int r=0; r<BATCH_REPEAT; r++)
+            MAX31856Linearization::compensateBatch(tc, mv, cj, batch, BATCH_SIZE);
+        auto t2 = std::chrono::steady_clock::now();
+
+        uint32_t mismatches = 0;
+        for(uint32_t i=0; i<BATCH_SIZE; i++)
+            if(isnan(scalar[i]) ? !isnan(batch[i]) : scalar[i] != batch[i]) mismatches++;
+        CHECK(mismatches == 0);
+        CHECK(isnan(batch[7]) && isnan(batch[9]));
+        printf("type %u compensate() %.1f ns/sample, compensateBatch() %.1f ns/sample\n", type,
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / (BATCH_REPEAT * BATCH_SIZE),
+            std::chrono::duration<double, std::nano>(t2 - t1).count() / (BATCH_REPEAT * BATCH_SIZE));
+
+        MAX31856Linearization::compensateBatch(tc, mv, cj, mv, BATCH_SIZE);    //in place
+        for(uint32_t i=0; i<BATCH_SIZE; i++)
+            if(!isnan(scalar[i]) && mv[i] != scalar[i]) mismatches++;
+        CHECK(mismatches == 0);
+    }
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testRoundTrip);
+    RUN_TEST(testNistReference);
+    RUN_TEST(testVoltageMode);
+    RUN_TEST(testBatchMatchesScalar);
+    return TEST_RESULT();
+}
@@ -0,0 +1,131 @@
+/******************************************************************//**
+* @file test_linear_table.cpp
+*
+* @version 1.0
+*
+* @brief Host test of MAX31856LinearTable against MAX31856Linearization::compensate() for every thermocouple type, with its conversion rate
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include <chrono>
+
+#define BATCH_SIZE      65536
+#define BATCH_REPEAT    20
+#define TABLE_ERROR_MAX 0.07f   //documented bound of MAX31856LinearTable, °C
+#define POLY_NOISE      0.005f  //rounding noise of the float evaluation of the NIST polynomials used as reference, °C
+
+static const float range_min[8] = {250, -200, -210, -200, -200, -50, -50, -200};   //B, E, J, K, N, R, S, T in °C
+static const float range_max[8] = {1820, 1000, 1200, 1372, 1300, 1768, 1768, 400};
+static int32_t raw[BATCH_SIZE];
+static int16_t cj_raw[BATCH_SIZE];
+static float mv[BATCH_SIZE], cj[BATCH_SIZE], reference[BATCH_SIZE], table_out[BATCH_SIZE];
+
+
+//*****************************************************************************
+static int32_t millivoltsToCode(float millivolts)
+{
+    return (int32_t)lrintf(millivolts * (1.6f * 131072.0f / 1000.0f) * MAX31856_VOLTAGE_GAIN_8);
+}
+
+
+//*****************************************************************************
+static void testMatchesCompensate()
+{
+    for(uint8_t type=CR1_TC_TYPE_B; type<=CR1_TC_TYPE_T; type++) {
+        const MAX31856Thermocouple* tc = MAX31856Linearization::getThermocouple(type);
+        MAX31856LinearTable table(type);
+        float bound = table.maxError();
+        CHECK(bound < TABLE_ERROR_MAX);
+
+        //hot junction over the range of the type, cold junction over the range of the MAX31856 at fractional temperatures
+        for(uint32_t i=0; i<BATCH_SIZE; i++) {
+            float t = range_min[type] + (range_max[type] - range_min[type]) * i / (BATCH_SIZE - 1);
+            cj_raw[i] = (int16_t)lrintf((-55.0f + 180.0f * ((i * 7919) % BATCH_SIZE) / BATCH_SIZE) * 256.0f);
+            cj[i] = cj_raw[i] * 0.00390625f;
+            raw[i] = millivoltsToCode(MAX31856Linearization::temperatureToMillivolts(tc, t) - MAX31856Linearization::temperatureToMillivolts(tc, cj[i]));
+            mv[i] = MAX31856Linearization::codeToMillivolts(raw[i], MAX31856_VOLTAGE_GAIN_8);
+        }
+        MAX31856Linearization::compensateBatch(tc, mv, cj, reference, BATCH_SIZE);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for(int r=0; r<BATCH_REPEAT; r++)
+            table.convertBatch(raw, cj_raw, table_out, BATCH_SIZE, MAX31856_VOLTAGE_GAIN_8);
+        auto t1 = std::chrono::steady_clock::now();
+        for(int r=0; r<BATCH_REPEAT; r++)
+            MAX31856Linearization::compensateBatch(tc, mv, cj, reference, BATCH_SIZE);
+        auto t2 = std::chrono::steady_clock::now();
+
+        float worst = 0.0f;
+        uint32_t invalid = 0, mismatches = 0;
+        for(uint32_t i=0; i<BATCH_SIZE; i++) {
+            if(isnan(reference[i]) || isnan(table_out[i])) {
+                if(isnan(reference[i]) != isnan(table_out[i])) invalid++;
+                continue;
+            }
+            worst = fmaxf(worst, fabsf(table_out[i] - reference[i]));
+            if(table_out[i] != table.convert(raw[i], cj_raw[i], MAX31856_VOLTAGE_GAIN_8)) mismatches++;
+        }
+        double table_s = std::chrono::duration<double>(t1 - t0).count();
+        double poly_s = std::chrono::duration<double>(t2 - t1).count();
+        printf("type %u: error %.4f °C (maxError() %.4f), convertBatch() %.1f Mconv/s, compensateBatch() %.1f Mconv/s\n", type,
+            worst, bound, BATCH_REPEAT * BATCH_SIZE / table_s * 1e-6, BATCH_REPEAT * BATCH_SIZE / poly_s * 1e-6);
+        CHECK(invalid == 0);                    //same range as the polynomials
+        CHECK(mismatches == 0);
+        CHECK(worst <= bound + POLY_NOISE);
+    }
+}
+
+
+//*****************************************************************************
+static void testOutsideTable()
+{
+    MAX31856LinearTable table(CR1_TC_TYPE_K);
+    CHECK(isnan(table.convert(0, (int16_t)(-60 * 256), MAX31856_VOLTAGE_GAIN_8)));     //cold junction below the MAX31856 range
+    CHECK(isnan(table.convert(0x3FFFF, 25 * 256, MAX31856_VOLTAGE_GAIN_8)));           //above the last point of type K
+    CHECK_NEAR(table.convert(0, 25 * 256, MAX31856_VOLTAGE_GAIN_8), 25.0, 0.05);      //no voltage, hot junction at the cold junction
+
+    MAX31856LinearTable empty(CR1_TC_TYPE_VOLT_MODE_GAIN_8);
+    CHECK(isnan(empty.convert(0, 25 * 256, MAX31856_VOLTAGE_GAIN_8)));
+    CHECK(isnan(empty.maxError()));
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testMatchesCompensate);
+    RUN_TEST(testOutsideTable);
+    return TEST_RESULT();
+}
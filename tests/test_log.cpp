@@ -0,0 +1,241 @@
+/******************************************************************//**
+* @file test_log.cpp
+*
+* @version 1.0
+*
+* @brief Host test and throughput of the binary sample log
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_log.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+#define SAMPLES         2000000
+#define DECODE_BATCH    256
+#define RESYNC_SAMPLES  50
+#define TEXT_BYTES      22          //bytes of a printf line "12345678,25.1234,25.12\n" per sample
+
+static std::vector<MAX31856LogRecord> samples;
+static std::vector<uint8_t> log_data;
+
+
+//*****************************************************************************
+static bool sameRecord(const MAX31856LogRecord& a, const MAX31856LogRecord& b)
+{
+    return a.timestamp_us == b.timestamp_us && a.tc_raw == b.tc_raw && a.cj_raw == b.cj_raw
+        && a.sr == b.sr && a.cr0 == b.cr0 && a.cr1 == b.cr1;
+}
+
+
+//*****************************************************************************
+static void makeSamples()
+{
+    std::mt19937 gen(4);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    uint32_t timestamp = 0xFFF00000u;       //wraps around during the log
+    float tc = 25 * 128;
+    samples.resize(SAMPLES);
+    for(int i=0; i<SAMPLES; i++) {
+        timestamp += 100000 + (int)(noise(gen) * 3);
+        tc += ((i < SAMPLES/2) ? 0.05f : -0.02f) + noise(gen) * 0.5f;
+        MAX31856LogRecord& r = samples[i];
+        r.timestamp_us = timestamp;
+        r.tc_raw = (int32_t)tc;
+        r.cj_raw = (int16_t)(25 * 256 + (int)noise(gen));
+        r.sr = (i % 100000 < 3) ? SR_OPEN : 0;
+        r.cr0 = (i < SAMPLES/2) ? 0x80 : 0x81;
+        r.cr1 = 0x03;
+    }
+    samples[5].tc_raw = -(1 << 18);         //extremes of the 19 bits
+    samples[6].tc_raw = (1 << 18) - 1;
+    samples[17].sr = SR_TC_RANGE;
+}
+
+
+//*****************************************************************************
+static void append(const MAX31856LogEncoder& encoder, uint32_t len)
+{
+    log_data.insert(log_data.end(), encoder.getBlock(), encoder.getBlock() + len);
+}
+
+
+//*****************************************************************************
+static void testEncode()
+{
+    makeSamples();
+    MAX31856LogEncoder encoder(samples[0].cr0, samples[0].cr1);
+    auto start = std::chrono::steady_clock::now();
+    for(int i=0; i<SAMPLES; i++) {
+        const MAX31856LogRecord& r = samples[i];
+        uint32_t len;
+        if(i && (r.cr0 != samples[i-1].cr0 || r.cr1 != samples[i-1].cr1)) {
+            len = encoder.setConfig(r.cr0, r.cr1);
+            if(len) append(encoder, len);
+        }
+        len = encoder.add(r.timestamp_us, r.tc_raw, r.cj_raw, r.sr);
+        CHECK(len <= MAX31856_LOG_BLOCK_SIZE);
+        if(len) append(encoder, len);
+    }
+    uint32_t len = encoder.flush();
+    if(len) append(encoder, len);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double per_sample = (double)log_data.size() / SAMPLES;
+    printf("%d samples: %zu bytes, %.2f bytes/sample (text about %d), %u blocks, encode %.1f Msamples/s\n",
+        SAMPLES, log_data.size(), per_sample, TEXT_BYTES, encoder.getBlockCount(), SAMPLES / seconds / 1e6);
+    CHECK(per_sample < 4.0);
+}
+
+
+//*****************************************************************************
+static void testDecode()
+{
+    static MAX31856LogRecord records[DECODE_BATCH];
+    MAX31856LogDecoder decoder(log_data.data(), log_data.size());
+    size_t count = 0, wrong = 0;
+    uint32_t n;
+    auto start = std::chrono::steady_clock::now();
+    while((n = decoder.read(records, DECODE_BATCH)) > 0) {
+        for(uint32_t i=0; i<n; i++, count++)
+            if(count >= samples.size() || !sameRecord(records[i], samples[count])) wrong++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("decode %.1f Msamples/s, %.0f MB/s\n", count / seconds / 1e6, log_data.size() / seconds / 1e6);
+    CHECK(count == samples.size());
+    CHECK(wrong == 0);
+    CHECK(decoder.getCorruptCount() == 0);
+}
+
+
+//*****************************************************************************
+static void testCorruption()
+{
+    std::vector<uint8_t> damaged(log_data);
+    damaged[1000] ^= 0x10;                  //a flipped bit in the second block
+    damaged.resize(damaged.size() - 7);     //and a truncated last block
+    MAX31856LogDecoder decoder(damaged.data(), damaged.size());
+    MAX31856LogDecoder reference(log_data.data(), log_data.size());
+    MAX31856LogRecord record;
+    size_t count = 0;
+    while(decoder.next(record)) count++;
+    size_t total = 0;
+    while(reference.next(record)) total++;
+    printf("damaged log: %zu of %zu samples decoded, %u corrupt blocks\n", count, total, decoder.getCorruptCount());
+    CHECK(decoder.getCorruptCount() == 2);
+    CHECK(decoder.getBlockCount() == reference.getBlockCount() - 2);
+    CHECK(count < total && count > total - 2 * MAX31856_LOG_BLOCK_SIZE);
+}
+
+
+//*****************************************************************************
+static void put16(std::vector<uint8_t>& v, uint32_t x) { v.push_back(x & 0xFF); v.push_back((x >> 8) & 0xFF); }
+static void put32(std::vector<uint8_t>& v, uint32_t x) { put16(v, x & 0xFFFF); put16(v, x >> 16); }
+
+static void testResync()
+{
+    //three valid blocks of RESYNC_SAMPLES samples
+    std::vector<MAX31856LogRecord> expected;
+    std::vector<uint8_t> blocks[3];
+    MAX31856LogEncoder encoder(0x80, 0x03);
+    for(int b=0; b<3; b++) {
+        for(int i=0; i<RESYNC_SAMPLES; i++) {
+            MAX31856LogRecord r = {1000u * (uint32_t)expected.size(), 25 * 128 + i * (b + 1), 25 * 256, 0, 0x80, 0x03};
+            CHECK(encoder.add(r.timestamp_us, r.tc_raw, r.cj_raw, r.sr) == 0);
+            expected.push_back(r);
+        }
+        uint32_t len = encoder.flush();
+        blocks[b].assign(encoder.getBlock(), encoder.getBlock() + len);
+    }
+
+    //a block with a valid CRC but a payload longer than the encoder ever writes
+    std::vector<uint8_t> oversized;
+    put16(oversized, MAX31856_LOG_MAGIC);
+    oversized.push_back(MAX31856_LOG_VERSION);
+    oversized.push_back(0x80);
+    oversized.push_back(0x03);
+    oversized.push_back(0);
+    put16(oversized, 1);                                    //samples
+    put16(oversized, 0);                                    //sample bytes
+    put16(oversized, MAX31856_LOG_BLOCK_SIZE);              //payload bytes
+    put32(oversized, 0);
+    oversized.resize(MAX31856_LOG_HEADER_SIZE + MAX31856_LOG_BLOCK_SIZE, 0);
+    put32(oversized, MAX31856LogDecoder::crc32(oversized.data(), oversized.size()));
+
+    //a header cut short by a power loss: magic, version and noise
+    std::vector<uint8_t> torn;
+    put16(torn, MAX31856_LOG_MAGIC);
+    torn.push_back(MAX31856_LOG_VERSION);
+    for(int i=0; i<9; i++) torn.push_back(0xA5 ^ i);
+
+    std::vector<uint8_t> stream = {0xFF, 0x00, 0x56, 0x38, 0x12};  //erased flash and noise before the first block
+    stream.insert(stream.end(), blocks[0].begin(), blocks[0].end());
+    stream.insert(stream.end(), oversized.begin(), oversized.end());
+    stream.insert(stream.end(), blocks[1].begin(), blocks[1].end());
+    stream.insert(stream.end(), torn.begin(), torn.end());
+    stream.insert(stream.end(), blocks[2].begin(), blocks[2].end());
+
+    MAX31856LogDecoder decoder(stream.data(), stream.size());
+    MAX31856LogRecord record;
+    size_t count = 0, wrong = 0;
+    while(decoder.next(record)) {
+        if(count >= expected.size() || !sameRecord(record, expected[count])) wrong++;
+        count++;
+    }
+    CHECK(count == expected.size());            //every valid block found again after each gap
+    CHECK(wrong == 0);
+    CHECK(decoder.getBlockCount() == 3);        //the oversized block is not taken despite its CRC
+    CHECK(decoder.getCorruptCount() == 3);      //one per gap
+}
+
+
+//*****************************************************************************
+static void testCrc()
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK(MAX31856LogDecoder::crc32(check, sizeof(check)) == 0xCBF43926);   //IEEE 802.3 check value
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testCrc);
+    RUN_TEST(testEncode);
+    RUN_TEST(testDecode);
+    RUN_TEST(testCorruption);
+    RUN_TEST(testResync);
+    return TEST_RESULT();
+}
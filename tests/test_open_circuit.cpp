@@ -0,0 +1,294 @@
+/******************************************************************//**
+* @file test_open_circuit.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the open circuit schedule: periodic and suspicion checks, detection kept on while open, latency and throughput
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN          10
+#define OC_BITS         0x30        //CR0 bits 5:4, open circuit detection
+#define BREAK_MS        5000
+#define RUN_MS          10000
+
+
+//*****************************************************************************
+static bool detectionOn(MAX31856Sim& sim)
+{
+    return (sim.getRegister(ADDRESS_CR0_READ) & OC_BITS) != 0;
+}
+
+
+//*****************************************************************************
+static bool freshResult(MAX31856& tc, MAX31856Sim& sim, float temperature)
+{
+    sim.setTemperature(temperature, 25.0f);
+    MAX31856Host::advance(200000);              //one new conversion, even with detection on
+    uint32_t frames = tc.getSpiFrameCount();
+    tc.readTC();
+    return tc.getSpiFrameCount() > frames;
+}
+
+
+//*****************************************************************************
+static void testEveryNthResult()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856::OpenCircuitSchedule schedule = {CR0_OC_DETECT_ENABLED_TC_MORE_2ms, 5, 0.0f, 0.0f, 0.0f, 0.0f};
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    CHECK(detectionOn(sim));                    //the first check starts at once
+
+    //the check ends with its second result, the next check starts with the interval-th result after it:
+    //a cycle of interval + MAX31856_OC_CHECK_RESULTS results
+    static const bool expected[14] = {true, false, false, false, false, false, true,
+                                      true, false, false, false, false, false, true};
+    for(int i=0; i<14; i++) {
+        CHECK(freshResult(tc, sim, 100.0f));
+        CHECK(detectionOn(sim) == expected[i]);
+    }
+    CHECK(tc.getOpenCircuitCheckCount() == 2);
+    CHECK(tc.getOpenCircuitSuspicionCount() == 0);
+
+    CHECK(tc.setOpenCircuitSchedule(NULL));     //detection left as it is
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(detectionOn(sim));
+}
+
+
+//*****************************************************************************
+static void testSuspicions()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856::OpenCircuitSchedule schedule = {CR0_OC_DETECT_ENABLED_R_LESS_5k, 0, 5.0f, 3.0f, 0.0f, 132.0f};
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(detectionOn(sim) == false);           //first check done
+
+    //results of a check are not watched, the steps and second differences below are between watched results
+    static const float steady[] = {100.0f, 101.0f, 102.0f, 103.0f};
+    for(unsigned i=0; i<sizeof(steady)/sizeof(steady[0]); i++) {
+        CHECK(freshResult(tc, sim, steady[i]));
+        CHECK(detectionOn(sim) == false);
+    }
+    CHECK(tc.getOpenCircuitSuspicionCount() == 0);
+
+    CHECK(freshResult(tc, sim, 108.0f));        //step of 5 °C, second difference of 4 °C
+    CHECK(detectionOn(sim));
+    CHECK(tc.getOpenCircuitSuspicionCount() == 1);
+    CHECK(freshResult(tc, sim, 108.0f));
+    CHECK(freshResult(tc, sim, 108.0f));
+    CHECK(detectionOn(sim) == false);
+    CHECK(tc.getOpenCircuitCheckCount() == 2);
+
+    CHECK(freshResult(tc, sim, 113.0f));        //same slope, second difference 0
+    CHECK(freshResult(tc, sim, 118.0f));
+    CHECK(detectionOn(sim) == false);
+    CHECK(freshResult(tc, sim, 125.0f));        //step of 7 °C, second difference of 2 °C
+    CHECK(detectionOn(sim));
+    CHECK(tc.getOpenCircuitSuspicionCount() == 2);
+    CHECK(freshResult(tc, sim, 125.0f));
+    CHECK(freshResult(tc, sim, 125.0f));
+    CHECK(detectionOn(sim) == false);
+
+    CHECK(freshResult(tc, sim, 130.0f));
+    CHECK(detectionOn(sim) == false);
+    CHECK(freshResult(tc, sim, 133.0f));        //above max_temperature, step of 3 °C, second difference of -2 °C
+    CHECK(detectionOn(sim));
+    CHECK(tc.getOpenCircuitSuspicionCount() == 3);
+    CHECK(tc.getOpenCircuitCheckCount() == 3);
+}
+
+
+//*****************************************************************************
+static void testOpenKeepsDetection()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856::OpenCircuitSchedule schedule = {CR0_OC_DETECT_ENABLED_R_LESS_5k, 3, 0.0f, 0.0f, 0.0f, 0.0f};
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(detectionOn(sim) == false);
+
+    sim.setOpenCircuit(true);                   //not seen while the detection is off
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(tc.getLastFaultStatus().open == false);
+    CHECK(freshResult(tc, sim, 100.0f));        //third result, the periodic check starts
+    CHECK(detectionOn(sim));
+    for(int i=0; i<10; i++) {
+        MAX31856Host::advance(200000);
+        CHECK_NEAR(tc.readTC(), 100.0, 0.01);   //result with a fault is not taken
+        CHECK(tc.getLastFaultStatus().open);
+        CHECK(detectionOn(sim));
+    }
+    CHECK(tc.getOpenCircuitCheckCount() == 1);
+
+    sim.setOpenCircuit(false);                  //repaired, the check completes
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(detectionOn(sim) == false);
+    CHECK(tc.getOpenCircuitCheckCount() == 2);
+}
+
+
+//*****************************************************************************
+static void testLatencyAndAverage()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    const uint32_t base = 82000, detection = MAX31856_OC_TIME_LONG_US;     //60 Hz filter, no averaging, continuous
+    CHECK(tc.getOpenCircuitLatency() == 0);     //detection off, never reported
+    CHECK(tc.getAverageConversionTime() == base);
+    CHECK(tc.setOpenCircuitFaultDetection(CR0_OC_DETECT_ENABLED_TC_MORE_2ms));
+    CHECK(tc.getOpenCircuitLatency() == base + detection);
+    CHECK(tc.getAverageConversionTime() == base + detection);
+
+    MAX31856::OpenCircuitSchedule schedule = {CR0_OC_DETECT_ENABLED_TC_MORE_2ms, 20, 0.0f, 0.0f, 0.0f, 0.0f};
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    uint32_t latency = (20 + MAX31856_OC_CHECK_RESULTS) * base + (MAX31856_OC_CHECK_RESULTS + 1) * detection;
+    CHECK(tc.getOpenCircuitLatency() == latency);
+    CHECK(tc.getAverageConversionTime() == latency / (20 + MAX31856_OC_CHECK_RESULTS));
+
+    schedule.interval = 0;                      //checks on suspicion only
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    CHECK(tc.getOpenCircuitLatency() == 0);
+    CHECK(tc.getAverageConversionTime() == base);
+}
+
+
+//*****************************************************************************
+static void testInvalidSchedules()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856::OpenCircuitSchedule schedule = {CR0_OC_DETECT_DISABLED, 5, 0.0f, 0.0f, 0.0f, 0.0f};
+    CHECK(tc.setOpenCircuitSchedule(&schedule) == false);
+    schedule.detection = CR0_OC_DETECT_ENABLED_R_LESS_5k;
+    schedule.step = -1.0f;
+    CHECK(tc.setOpenCircuitSchedule(&schedule) == false);
+    schedule.step = 0.0f;
+    schedule.noise = NAN;
+    CHECK(tc.setOpenCircuitSchedule(&schedule) == false);
+    schedule.noise = 0.0f;
+    schedule.min_temperature = 10.0f;
+    CHECK(tc.setOpenCircuitSchedule(&schedule) == false);
+
+    //huge and infinite thresholds are clamped instead of overflowing the conversion to 1/128 °C
+    schedule.step = 1e30f;
+    schedule.noise = INFINITY;
+    schedule.min_temperature = -INFINITY;
+    schedule.max_temperature = 3e38f;
+    CHECK(tc.setOpenCircuitSchedule(&schedule));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 100.0f));
+    CHECK(freshResult(tc, sim, 1000.0f));
+    CHECK(freshResult(tc, sim, -200.0f));
+    CHECK(tc.getOpenCircuitSuspicionCount() == 0);
+}
+
+
+//*****************************************************************************
+//Simulation of the trade-off: results per second before a broken wire at BREAK_MS, then the time until the fault status reports it
+static void runSchedule(const char* name, const MAX31856::OpenCircuitSchedule* schedule, uint8_t detection)
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(100.0f, 25.0f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.setOpenCircuitFaultDetection(detection));
+    CHECK(tc.setOpenCircuitSchedule(schedule));
+    uint32_t results = 0, detected_ms = 0;
+    for(int ms=0; ms<RUN_MS && !detected_ms; ms++) {
+        if(ms == BREAK_MS) {
+            sim.setOpenCircuit(true);
+            sim.setTemperature(1372.0f, 25.0f); //open input runs to the end of the range
+        }
+        MAX31856Host::advance(1000);
+        uint32_t frames = tc.getSpiFrameCount();
+        tc.readTC();
+        if(tc.getSpiFrameCount() == frames) continue;
+        if(ms < BREAK_MS) results++;
+        else if(tc.getLastFaultStatus().open) detected_ms = ms - BREAK_MS;
+    }
+    double rate = results * 1000.0 / BREAK_MS;
+    if(detected_ms) printf("%-20s %5.1f results/s, detected in %u ms\n", name, rate, detected_ms);
+    else printf("%-20s %5.1f results/s, open circuit never seen\n", name, rate);
+    if(schedule && schedule->interval) {
+        printf("%-20s predicted %.1f ms/result, worst case latency %.2f s\n", "", tc.getAverageConversionTime() / 1000.0,
+            tc.getOpenCircuitLatency() / 1e6);
+        CHECK_NEAR(rate, 1e6 / tc.getAverageConversionTime(), 0.5);
+        CHECK(detected_ms * 1000 <= tc.getOpenCircuitLatency());
+    }
+    if(detection || schedule) CHECK(detected_ms);
+    else CHECK(detected_ms == 0);
+}
+
+
+static void testSimulation()
+{
+    MAX31856::OpenCircuitSchedule periodic = {CR0_OC_DETECT_ENABLED_TC_MORE_2ms, 20, 0.0f, 0.0f, 0.0f, 0.0f};
+    MAX31856::OpenCircuitSchedule suspicion = {CR0_OC_DETECT_ENABLED_TC_MORE_2ms, 0, 50.0f, 0.0f, 0.0f, 0.0f};
+    runSchedule("detection off", NULL, CR0_OC_DETECT_DISABLED);
+    MAX31856Host::reset();
+    runSchedule("always on", NULL, CR0_OC_DETECT_ENABLED_TC_MORE_2ms);
+    MAX31856Host::reset();
+    runSchedule("every 20 results", &periodic, CR0_OC_DETECT_DISABLED);
+    MAX31856Host::reset();
+    runSchedule("on suspicion only", &suspicion, CR0_OC_DETECT_DISABLED);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testEveryNthResult);
+    RUN_TEST(testSuspicions);
+    RUN_TEST(testOpenKeepsDetection);
+    RUN_TEST(testLatencyAndAverage);
+    RUN_TEST(testInvalidSchedules);
+    RUN_TEST(testSimulation);
+    return TEST_RESULT();
+}
@@ -0,0 +1,123 @@
+/******************************************************************//**
+* @file test_raw.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the fixed point reads and of the integer conversion time
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+
+#define TC_PIN      10
+
+static_assert(MAX31856::tcRawToCelsius(128) == 1.0f, "1/128 °C");
+static_assert(MAX31856::cjRawToCelsius(-256) == -1.0f, "1/256 °C");
+static_assert(MAX31856::tcRawToMilliCelsius(-64) == -500, "1/128 °C");
+static_assert(MAX31856::cjRawToMilliCelsius(25 * 256 + 64) == 25250, "1/256 °C");
+
+
+//*****************************************************************************
+static void testRawMatchesFloat()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    for(float t=-200.0f; t<=1300.0f; t+=37.3f) {
+        sim.setTemperature(t, t / 20.0f);
+        MAX31856Host::advance(200000);
+        int32_t raw = tc.readTCRaw();
+        CHECK(raw == (int32_t)lrintf(t * 128.0f));                  //19 bits, 1/128 °C
+        CHECK(tc.readTC() == MAX31856::tcRawToCelsius(raw));        //previous result, no bus access
+        CHECK(tc.getLastTC() == MAX31856::tcRawToCelsius(raw));
+        int16_t cj_raw = tc.readCJRaw();
+        CHECK_NEAR(MAX31856::cjRawToCelsius(cj_raw), t / 20.0f, 1.0 / 64);
+        CHECK(tc.readCJ() == MAX31856::cjRawToCelsius(cj_raw));
+        CHECK((cj_raw & 0x03) == 0);                                //2 LSB always 0
+    }
+}
+
+
+//*****************************************************************************
+static void testInvalidRaw()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc.readTCRaw() == TC_RAW_INVALID);                        //no reading available yet
+    CHECK(isnan(tc.readTC()));
+    MAX31856Host::advance(200000);
+    CHECK(tc.readTCRaw() != TC_RAW_INVALID);
+}
+
+
+//*****************************************************************************
+static void testDelayMatchesConversionTime()
+{
+    //the integer conversion time of the reads must never be shorter than the conversion of the device
+    const uint8_t averaging[] = {CR1_AVG_TC_SAMPLES_1, CR1_AVG_TC_SAMPLES_2, CR1_AVG_TC_SAMPLES_4, CR1_AVG_TC_SAMPLES_8, CR1_AVG_TC_SAMPLES_16};
+    const uint8_t filters[] = {CR0_FILTER_OUT_60Hz, CR0_FILTER_OUT_50Hz};
+    for(uint8_t filter : filters) {
+        for(uint8_t avg : averaging) {
+            MAX31856Host::reset();
+            SPI spi(0, 1, 2);
+            MAX31856Sim sim(TC_PIN);
+            MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, filter, avg, CR0_CONV_MODE_NORMALLY_ON);
+            MAX31856Host::advance(1000000);
+            tc.readTC();                                            //first fresh result, the next ones use the continuous time
+            MAX31856Host::advance(sim.conversionTime());
+            tc.readTC();
+            uint32_t conversions = sim.getConversionCount();
+            uint32_t frames = tc.getSpiFrameCount();
+            uint64_t start = MAX31856Host::now();
+            while(tc.getSpiFrameCount() == frames) {
+                MAX31856Host::advance(100);
+                tc.readTC();
+            }
+            uint32_t waited = (uint32_t)(MAX31856Host::now() - start);
+            CHECK(sim.getConversionCount() > conversions);          //the read found a new result
+            CHECK(waited <= sim.conversionTime() + 100);
+        }
+    }
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testRawMatchesFloat);
+    RUN_TEST(testInvalidRaw);
+    RUN_TEST(testDelayMatchesConversionTime);
+    return TEST_RESULT();
+}
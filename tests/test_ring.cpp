@@ -0,0 +1,198 @@
+/******************************************************************//**
+* @file test_ring.cpp
+*
+* @version 1.0
+*
+* @brief Host test of MAX31856Ring and readSample(): wrap-around, overflow, popBatch() and a producer and a consumer thread
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_ring.h"
+#include <thread>
+#include <atomic>
+
+#define TC_PIN          10
+#define THREAD_ITEMS    200000
+
+
+//*****************************************************************************
+static void testWrapAround()
+{
+    MAX31856Ring<uint32_t, 8> ring;
+    CHECK(ring.capacity() == 8);
+    uint32_t next_push = 0, next_pop = 0, wrong = 0;
+    for(int round=0; round<100; round++) {      //5 at a time, the slots wrap around every few rounds
+        for(int i=0; i<5; i++) CHECK(ring.push(next_push++));
+        CHECK(ring.size() == 5);
+        uint32_t item;
+        for(int i=0; i<5; i++)
+            if(!ring.pop(item) || item != next_pop++) wrong++;
+        CHECK(ring.size() == 0);
+    }
+    CHECK(wrong == 0);
+    CHECK(ring.getDroppedCount() == 0);
+}
+
+
+//*****************************************************************************
+static void testOverflow()
+{
+    MAX31856Ring<uint32_t, 8> ring;
+    for(uint32_t i=0; i<8; i++) CHECK(ring.push(i));
+    CHECK(ring.push(100) == false);             //full, dropped
+    CHECK(ring.push(101) == false);
+    CHECK(ring.size() == 8);
+    CHECK(ring.getDroppedCount() == 2);
+
+    uint32_t item;
+    CHECK(ring.pop(item) && item == 0);
+    CHECK(ring.push(8));                        //one slot free again
+    CHECK(ring.push(102) == false);
+    CHECK(ring.getDroppedCount() == 3);
+    for(uint32_t i=1; i<=8; i++) CHECK(ring.pop(item) && item == i);    //the dropped elements left no gap in the ring
+    CHECK(ring.pop(item) == false);
+    CHECK(ring.getDroppedCount() == 3);         //not reset by the consumer
+}
+
+
+//*****************************************************************************
+static void testPopBatch()
+{
+    MAX31856Ring<uint32_t, 8> ring;
+    uint32_t items[10];
+    CHECK(ring.popBatch(items, 10) == 0);       //empty
+    for(uint32_t i=0; i<6; i++) ring.push(i);
+    CHECK(ring.popBatch(items, 4) == 4);
+    for(uint32_t i=0; i<4; i++) CHECK(items[i] == i);
+    for(uint32_t i=6; i<12; i++) ring.push(i); //wraps around the end of the storage
+    CHECK(ring.popBatch(items, 10) == 8);
+    for(uint32_t i=0; i<8; i++) CHECK(items[i] == i + 4);
+    CHECK(ring.popBatch(items, 0) == 0);
+    CHECK(ring.size() == 0);
+}
+
+
+//*****************************************************************************
+static void testReadSample()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(200.5f, 24.25f);
+    MAX31856 tc(spi, TC_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Ring<MAX31856::Sample, 4> ring;
+    MAX31856::Sample sample;
+    CHECK(tc.readSample(sample) == false);      //no conversion started
+    CHECK(tc.startConversion());
+    CHECK(tc.readSample(sample) == false);      //in progress
+    MAX31856Host::advance(sim.conversionTime());
+
+    uint32_t frames = tc.getSpiFrameCount();
+    CHECK(tc.readSample(sample));
+    CHECK(tc.getSpiFrameCount() == frames + 1); //CJTH to SR in a single frame
+    CHECK(sample.timestamp_us == (uint32_t)MAX31856Host::now());
+    CHECK(sample.tc_raw == (int32_t)(200.5f * 128));
+    CHECK(sample.cj_raw == (int16_t)(24.25f * 256));
+    CHECK(sample.sr == 0);
+    CHECK(tc.readSample(sample) == false);      //next conversion started, not ready yet
+    CHECK(ring.push(sample));
+
+    for(int i=0; i<3; i++) {
+        MAX31856Host::advance(sim.conversionTime());
+        CHECK(tc.readSample(sample));
+        CHECK(ring.push(sample));
+    }
+    MAX31856::Sample batch[4];
+    CHECK(ring.popBatch(batch, 4) == 4);
+    for(int i=1; i<4; i++) CHECK(batch[i].timestamp_us > batch[i-1].timestamp_us);
+}
+
+
+//*****************************************************************************
+//Producer and consumer on two threads: every element arrives once, in order and complete. The producer retries a
+//dropped element so that the ring runs both full and empty while the two threads race
+static MAX31856Ring<MAX31856::Sample, 64> shared_ring;
+static std::atomic<bool> consumer_running(false);
+
+static void producer()
+{
+    while(!consumer_running) std::this_thread::yield();
+    for(uint32_t i=0; i<THREAD_ITEMS; i++) {
+        MAX31856::Sample sample;
+        sample.timestamp_us = i;
+        sample.tc_raw = (int32_t)(i * 3);
+        sample.cj_raw = (int16_t)(i & 0x7FFF);
+        sample.sr = (uint8_t)i;
+        while(!shared_ring.push(sample)) std::this_thread::yield();
+    }
+}
+
+
+static void testTwoThreads()
+{
+    uint32_t received = 0, gaps = 0, torn = 0, empty_polls = 0;
+    std::thread thread(producer);
+    consumer_running = true;
+    MAX31856::Sample batch[16];
+    while(received < THREAD_ITEMS) {
+        uint32_t n = shared_ring.popBatch(batch, 16);
+        if(!n) {
+            empty_polls++;
+            std::this_thread::yield();
+        }
+        for(uint32_t i=0; i<n; i++) {
+            uint32_t index = batch[i].timestamp_us;
+            if(index != received + i) gaps++;
+            if(batch[i].tc_raw != (int32_t)(index * 3) || batch[i].cj_raw != (int16_t)(index & 0x7FFF) || batch[i].sr != (uint8_t)index) torn++;
+        }
+        received += n;
+    }
+    thread.join();
+    printf("%u received, %u pushes refused on a full ring, %u polls of an empty ring\n", received, shared_ring.getDroppedCount(), empty_polls);
+    CHECK(gaps == 0);
+    CHECK(torn == 0);
+    CHECK(shared_ring.size() == 0);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testWrapAround);
+    RUN_TEST(testOverflow);
+    RUN_TEST(testPopBatch);
+    RUN_TEST(testReadSample);
+    RUN_TEST(testTwoThreads);
+    return TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+/******************************************************************//**
+* @file test_spi_lock.cpp
+*
+* @version 1.0
+*
+* @brief Host stress test of the SPI bus shared by several threads
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include <thread>
+
+#define FIRST_PIN       10
+#define FOREIGN_PIN     30
+#define THREADS         4
+#define ITERATIONS      2000
+
+static std::atomic<uint32_t> wrong_results(0);
+static std::atomic<bool> running(false);
+
+
+//*****************************************************************************
+static void readLoop(MAX31856* tc, float temperature, float cold_junction)
+{
+    for(int i=0; i<ITERATIONS; i++) {
+        float cj = tc->readCJ();
+        float t = tc->readTC();
+        if(fabsf(cj - cold_junction) > 0.02f) wrong_results++;
+        if(!isnan(t) && fabsf(t - temperature) > 0.01f) wrong_results++;
+        if(i % 100 == 0 && !tc->setNumSamplesAvg((i % 200) ? CR1_AVG_TC_SAMPLES_2 : CR1_AVG_TC_SAMPLES_1)) wrong_results++;
+    }
+}
+
+
+//*****************************************************************************
+static void foreignLoop(SPI* spi)
+{
+    DigitalOut cs(FOREIGN_PIN);
+    while(running) {                        //driver of a mode 0 device on the same bus
+        spi->lock();
+        spi->format(8, 0);
+        spi->frequency(4000000);
+        cs = 0;
+        for(int i=0; i<4; i++) spi->write(0x55);
+        cs = 1;
+        spi->unlock();
+    }
+}
+
+
+//*****************************************************************************
+static void runThreads(bool foreign)
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim* sims[THREADS];
+    MAX31856* devices[THREADS];
+    std::thread threads[THREADS];
+    for(int i=0; i<THREADS; i++) {
+        sims[i] = new MAX31856Sim(FIRST_PIN + i);
+        sims[i]->setTemperature(100.0f + 10*i, 20.0f + i);
+        devices[i] = new MAX31856(spi, FIRST_PIN + i, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+        devices[i]->setSpiShared(foreign);
+    }
+    MAX31856Host::advance(200000);          //first conversions completed
+    spi.resetCounters();
+    wrong_results = 0;
+    running = true;
+    std::thread other;
+    if(foreign) other = std::thread(foreignLoop, &spi);
+    for(int i=0; i<THREADS; i++)
+        threads[i] = std::thread(readLoop, devices[i], 100.0f + 10*i, 20.0f + i);
+    for(int i=0; i<THREADS; i++) threads[i].join();
+    running = false;
+    if(foreign) other.join();
+
+    printf("%d threads%s: %u frames, %u bytes, %u wrong results, %u bytes clocked with a bad selection or mode\n", THREADS,
+        foreign ? " and a mode 0 driver" : "", spi.getFrameCount(), spi.getByteCount(), wrong_results.load(), spi.getErrorCount());
+    CHECK(wrong_results == 0);
+    CHECK(spi.getErrorCount() == 0);        //never two chip selects low at once, the MAX31856 frames always in mode 3
+    for(int i=0; i<THREADS; i++) {
+        CHECK(devices[i]->verifyConfig());
+        delete devices[i];
+        delete sims[i];
+    }
+}
+
+
+//*****************************************************************************
+static void testThreads()
+{
+    runThreads(false);
+}
+
+
+//*****************************************************************************
+static void testSharedWithModeZeroDevice()
+{
+    runThreads(true);
+}
+
+
+//*****************************************************************************
+static void testSeparateSpiObjects()
+{
+    SPI spi_a(0, 1, 2), spi_b(3, 4, 5);     //the simulation has a single bus, so the objects are used one after the other
+    MAX31856Sim sim_a(FIRST_PIN), sim_b(FIRST_PIN + 1);
+    sim_a.setTemperature(100.0f, 20.0f);
+    sim_b.setTemperature(200.0f, 21.0f);
+    MAX31856 tc_a(spi_a, FIRST_PIN, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856 tc_b(spi_b, FIRST_PIN + 1, CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1, CR0_CONV_MODE_NORMALLY_ON);
+    CHECK(tc_b.setSpiFrequency(4000000));
+    MAX31856Host::advance(200000);
+    spi_a.resetCounters();
+    spi_b.resetCounters();
+    for(int i=0; i<10; i++) {
+        CHECK_NEAR(tc_a.readCJ(), 20.0, 0.02);
+        CHECK_NEAR(tc_b.readCJ(), 21.0, 0.02);
+    }
+    CHECK(spi_a.getFormatCount() == 0);     //each SPI object keeps the format of its own device
+    CHECK(spi_b.getFormatCount() == 1);     //applied once for the new frequency
+    CHECK(spi_b.getFrequency() == 4000000);
+    CHECK(spi_a.getErrorCount() == 0);
+    CHECK(spi_b.getErrorCount() == 0);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    DigitalOut init(FOREIGN_PIN);           //pins are set up before the threads start
+    RUN_TEST(testThreads);
+    RUN_TEST(testSharedWithModeZeroDevice);
+    RUN_TEST(testSeparateSpiObjects);
+    return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+/******************************************************************//**
+* @file test_static.cpp
+*
+* @version 1.0
+*
+* @brief Host test of the compile-time configuration of MAX31856T
+*
+***********************************************************************
+*
+* @copyright 
+* Copyright (C) 2017 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+**********************************************************************/
+#include "MAX31856_test.h"
+#include "lib_MAX31856_static.h"
+
+#define TC_PIN      10
+#define REF_PIN     11
+
+static_assert(MAX31856T<CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4>::CONVERSION_TIME_US == 218000, "data sheet table 3");
+static_assert(MAX31856T<CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_16>::SAMPLES == 16, "averaging");
+static_assert(MAX31856T<CR1_TC_TYPE_VOLT_MODE_GAIN_32>::VOLTAGE_MODE, "voltage mode");
+
+
+//*****************************************************************************
+template<uint8_t Type, uint8_t Filter, uint8_t Avg>
+static void checkConfiguration()
+{
+    typedef MAX31856T<Type, Filter, Avg, CR0_CONV_MODE_NORMALLY_ON> Thermocouple;
+    MAX31856Host::reset();
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    MAX31856Sim ref_sim(REF_PIN);
+    Thermocouple tc(spi, TC_PIN);
+    CHECK(fabs((double)Thermocouple::CONVERSION_TIME_US - sim.conversionTime()) < 1000);
+    MAX31856Host::advance(Thermocouple::CONVERSION_TIME_US - 1);   //the constants agree with the conversion time used at run time
+    CHECK(tc.isInitialized() == false);
+    MAX31856Host::advance(1);
+    CHECK(tc.isInitialized());
+
+    MAX31856 ref(spi, REF_PIN, Type, Filter, Avg, CR0_CONV_MODE_NORMALLY_ON);
+    MAX31856Host::advance(Thermocouple::CONVERSION_TIME_US - 1);
+    CHECK(ref.isInitialized() == false);
+    MAX31856Host::advance(1);
+    CHECK(ref.isInitialized());
+    CHECK(sim.getRegister(ADDRESS_CR0_READ) == Thermocouple::CR0);
+    CHECK(sim.getRegister(ADDRESS_CR1_READ) == Thermocouple::CR1);
+    CHECK(ref_sim.getRegister(ADDRESS_CR0_READ) == Thermocouple::CR0);      //same registers as the validating setters
+    CHECK(ref_sim.getRegister(ADDRESS_CR1_READ) == Thermocouple::CR1);
+    CHECK(tc.getSpiFrameCount() <= ref.getSpiFrameCount());
+    CHECK(fabs((double)Thermocouple::CONTINUOUS_CONVERSION_TIME_US - sim.conversionTime()) < 1000);
+}
+
+
+//*****************************************************************************
+static void testConfigurations()
+{
+    checkConfiguration<CR1_TC_TYPE_K, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_1>();
+    checkConfiguration<CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4>();
+    checkConfiguration<CR1_TC_TYPE_T, CR0_FILTER_OUT_60Hz, CR1_AVG_TC_SAMPLES_16>();
+    checkConfiguration<CR1_TC_TYPE_B, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_2>();
+}
+
+
+//*****************************************************************************
+static void testRead()
+{
+    SPI spi(0, 1, 2);
+    MAX31856Sim sim(TC_PIN);
+    sim.setTemperature(300.0f, 25.0f);
+    MAX31856T<CR1_TC_TYPE_J, CR0_FILTER_OUT_50Hz, CR1_AVG_TC_SAMPLES_4, CR0_CONV_MODE_NORMALLY_ON> tc(spi, TC_PIN);
+    MAX31856Host::advance(300000);
+    CHECK_NEAR(tc.readTC(), 300.0, 0.01);
+}
+
+
+//*****************************************************************************
+int main()
+{
+    RUN_TEST(testConfigurations);
+    RUN_TEST(testRead);
+    return TEST_RESULT();
+}